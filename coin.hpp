@@ -1,6 +1,6 @@
 #pragma once
 #include "splashkit.h"
-#include <vector>
+#include "game/anim_clip.hpp"
 
 // Represents a coin dropped by enemies
 struct Coin
@@ -9,10 +9,5 @@ struct Coin
     double value;              // Amount of money this coin gives
     bool active = false;       // Whether the coin is active/visible
 
-    // Animation data
-    std::vector<bitmap> frames; // All animation frames for the coin
-    int frame = 0;              // Current frame index
-    int frame_timer = 0;        // Timer for frame switching
-    int frame_interval = 0;     // Frames between animation updates
-    int frame_count = 0;        // Total number of animation frames
+    AnimPlayhead anim;         // Spin (coin_clip(), frames GameWorld::coin_frames)
 };
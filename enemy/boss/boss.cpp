@@ -1,9 +1,11 @@
 #include "boss.hpp"
+#include "../../game/game_world.hpp"
+#include "../../game/audio.hpp"
+#include "../../render/sprite_cache.hpp"
+#include "../../render/world_layer.hpp"
 #include <cmath>
 #include <algorithm>
 
-extern int block_flash_timer;
-
 namespace
 {
     constexpr double PI = 3.141592654;
@@ -26,12 +28,25 @@ namespace
     constexpr int LASER_GROW_FRAMES = 5 * FPS;
     constexpr double LASER_ROTATE_RATE = 0.0008;
     constexpr double LASER_MAX_LENGTH = 1200.0;
+    constexpr double LASER_REACH = 14.0;        // Hits a player centre this close to the beam
+    constexpr double PHASE2_HP_MULT = 1.5;     // Phase 2 health, relative to phase 1
+
+    // Sprite order in enemies.def
+    enum Sprite
+    {
+        SPRITE_REGULAR,
+        SPRITE_HALF0,
+        SPRITE_HALF1,
+        SPRITE_LOWHP,
+        SPRITE_DEAD,
+        SPRITE_REBIRTH,
+        SPRITE_PLAYER_LOSE,
+        SPRITE_BULLET_FAN
+    };
 
-    inline int rand_range(int min_val, int max_val)
-    {
-        if (max_val <= min_val) return min_val;
-        return min_val + rnd(max_val - min_val + 1);
-    }
+    // Half-health cue: the first painting, then the second until the cue ends
+    // (played by state_timer_, which restarts with every state)
+    const AnimClip half_cue_clip({{SPRITE_HALF0, 84}, {SPRITE_HALF1, SFX_HALF_FRAMES - 84}}, false);
 
     inline double clamp(double v, double lo, double hi)
     {
@@ -39,123 +54,61 @@ namespace
         if (v > hi) return hi;
         return v;
     }
-
-    inline bool point_in_rect(double px, double py, double rx, double ry, double rw, double rh)
-    {
-        return (px >= rx && px <= rx + rw && py >= ry && py <= ry + rh);
-    }
-
-    inline bool segment_intersects_rect(double x1, double y1, double x2, double y2,
-                                        double rx, double ry, double rw, double rh)
-    {
-        if (point_in_rect(x1, y1, rx, ry, rw, rh) || point_in_rect(x2, y2, rx, ry, rw, rh))
-            return true;
-
-        auto cross = [](double ux, double uy, double vx, double vy) { return ux * vy - uy * vx; };
-
-        auto seg_intersect = [&](double ax, double ay, double bx, double by,
-                                 double cx, double cy, double dx, double dy) {
-            double abx = bx - ax, aby = by - ay;
-            double acx = cx - ax, acy = cy - ay;
-            double adx = dx - ax, ady = dy - ay;
-            double cdx = dx - cx, cdy = dy - cy;
-            double cax = ax - cx, cay = ay - cy;
-
-            double d1 = cross(abx, aby, acx, acy);
-            double d2 = cross(abx, aby, adx, ady);
-            double d3 = cross(cdx, cdy, cax, cay);
-            double d4 = cross(cdx, cdy, bx - cx, by - cy);
-
-            return (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) &&
-                    ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)));
-        };
-
-        double left   = rx;
-        double right  = rx + rw;
-        double top    = ry;
-        double bottom = ry + rh;
-
-        if (seg_intersect(x1, y1, x2, y2, left,  top, left,  bottom)) return true;
-        if (seg_intersect(x1, y1, x2, y2, right, top, right, bottom)) return true;
-        if (seg_intersect(x1, y1, x2, y2, left,  top, right, top))    return true;
-        if (seg_intersect(x1, y1, x2, y2, left,  bottom, right, bottom)) return true;
-        return false;
-    }
 }
 
-Boss::Boss()
+int Boss::phase2_hp() const
 {
-    width = 200;
-    height = 200;
-    hp = max_hp_phase1_;
+    return static_cast<int>(phase1_hp() * PHASE2_HP_MULT);
 }
 
-void Boss::load_assets()
+void Boss::play_stage1_bgm(GameWorld &world, bool force_restart)
 {
-    load_bitmap("boss_regular", "../image/enemy/BOSS/regular.png");
-    load_bitmap("boss_half0",    "../image/enemy/BOSS/half_life_0.png");
-    load_bitmap("boss_half1",    "../image/enemy/BOSS/half_life_1.png");
-    load_bitmap("boss_lowhp",    "../image/enemy/BOSS/low_hp.png");
-    load_bitmap("boss_dead",     "../image/enemy/BOSS/stage_1_dead.png");
-    load_bitmap("boss_rebirth",  "../image/enemy/BOSS/rebirth.png");
-    load_bitmap("boss_plose",    "../image/enemy/BOSS/player_lose.png");
-    load_bitmap("bullet_alt2_1", "../image/weapon/Bullet_Alt2_1.png");
-
-    img_regular_     = bitmap_named("boss_regular");
-    img_half0_       = bitmap_named("boss_half0");
-    img_half1_       = bitmap_named("boss_half1");
-    img_lowhp_       = bitmap_named("boss_lowhp");
-    img_dead_        = bitmap_named("boss_dead");
-    img_rebirth_     = bitmap_named("boss_rebirth");
-    img_player_lose_ = bitmap_named("boss_plose");
-    img_bullet_fan_  = bitmap_named("bullet_alt2_1");
-
-    enter_state(State::Intro);
-}
+    if (world.headless)
+        return;
 
-void Boss::play_stage1_bgm(bool force_restart)
-{
     if (force_restart)
     {
-        stop_music();
+        stop_bgm(world);
         bgm_stage1_playing_ = false;
         bgm_stage2_playing_ = false;
     }
 
     if (!bgm_stage1_playing_)
     {
-        load_music("stage1", "../sound/bgm/stage_1_bgm.mp3");
-        play_music("stage1", -1);
-        set_music_volume(0.5);
+        start_bgm(world, "stage1", "../sound/bgm/stage_1_bgm.mp3", 0.5);
         bgm_stage1_playing_ = true;
         bgm_stage2_playing_ = false;
     }
 }
 
-void Boss::play_stage2_bgm(bool force_restart)
+void Boss::play_stage2_bgm(GameWorld &world, bool force_restart)
 {
+    if (world.headless)
+        return;
+
     if (!force_restart && stage2_bgm_pending_)
         return;
 
     if (force_restart)
     {
-        stop_music();
+        stop_bgm(world);
         bgm_stage1_playing_ = false;
         bgm_stage2_playing_ = false;
     }
 
     if (!bgm_stage2_playing_)
     {
-        load_music("stage2", "../sound/bgm/stage_2_bgm.mp3");
-        play_music("stage2", -1);
-        set_music_volume(1.0);
+        start_bgm(world, "stage2", "../sound/bgm/stage_2_bgm.mp3", 1.0);
         bgm_stage2_playing_ = true;
         bgm_stage1_playing_ = false;
     }
 }
 
-void Boss::stop_active_sfx()
+void Boss::stop_active_sfx(GameWorld &world)
 {
+    if (world.headless)
+        return;
+
     const char* names[] = {
         "boss_hit_player",
         "boss_dead",
@@ -167,27 +120,19 @@ void Boss::stop_active_sfx()
     };
 
     for (const char* name : names)
-    {
-        sound_effect fx = sound_effect_named(name);
-        if (fx)
-            stop_sound_effect(fx);
-    }
+        stop_sfx(world, name);
 }
 
-static void play_sfx_boosted(const std::string &name)
+static void play_sfx_boosted(GameWorld &world, const std::string &name, const std::string &path)
 {
-    sound_effect fx = sound_effect_named(name);
-    if (!fx)
-        return;
-
     // Play multiple overlapping instances to approximate a 3.5× gain.
-    play_sound_effect(fx, 1.0);
-    play_sound_effect(fx, 1.0);
-    play_sound_effect(fx, 1.0);
-    play_sound_effect(fx, 0.5);
+    play_sfx(world, name, path, 1.0);
+    play_sfx(world, name, path, 1.0);
+    play_sfx(world, name, path, 1.0);
+    play_sfx(world, name, path, 0.5);
 }
 
-void Boss::enter_state(State new_state)
+void Boss::enter_state(GameWorld &world, State new_state)
 {
     state_ = new_state;
     state_timer_ = 0;
@@ -198,7 +143,7 @@ void Boss::enter_state(State new_state)
     case State::Intro:
         shots_.clear();
         lasers_.clear();
-        reset_position_to_center();
+        reset_position_to_center(world);
         y = -height - 40;
         vx_ = vy_ = 0.0;
         initial_p1_rest_done_ = false;
@@ -209,7 +154,7 @@ void Boss::enter_state(State new_state)
         state_limit_ = 10 * FPS;
         shots_.clear();
         vx_ = vy_ = 0.0;
-        fan_angle_offset_ = rnd(360) * PI / 180.0;
+        fan_angle_offset_ = world.rng.below(360) * PI / 180.0;
         break;
 
     case State::P1_Rest:
@@ -220,41 +165,37 @@ void Boss::enter_state(State new_state)
         }
         else
         {
-            state_limit_ = rand_range(P1_REST_MIN, P1_REST_MAX);
+            state_limit_ = world.rng.range(P1_REST_MIN, P1_REST_MAX);
         }
         break;
 
     case State::PhaseHalfCue:
         state_limit_ = SFX_HALF_FRAMES;
-        load_sound_effect("boss_half", "../sound/BOSS/half_life.mp3");
-        play_sfx_boosted("boss_half");
+        play_sfx_boosted(world, "boss_half", "../sound/BOSS/half_life.mp3");
         break;
 
     case State::LowHpCue:
         state_limit_ = SFX_LOWHP_FRAMES;
-        load_sound_effect("boss_lowhp", "../sound/BOSS/low_hp.mp3");
-        play_sfx_boosted("boss_lowhp");
+        play_sfx_boosted(world, "boss_lowhp", "../sound/BOSS/low_hp.mp3");
         break;
 
     case State::Phase1Death:
         state_limit_ = SFX_DEAD_FRAMES;
-        load_sound_effect("boss_dead", "../sound/BOSS/dead.mp3");
-        play_sfx_boosted("boss_dead");
+        play_sfx_boosted(world, "boss_dead", "../sound/BOSS/dead.mp3");
         shots_.clear();
         break;
 
     case State::Rebirth:
-        stop_active_sfx();
-        stop_music();
+        stop_active_sfx(world);
+        stop_bgm(world);
         state_limit_ = REBIRTH_DISPLAY_FRAMES;
         stage2_bgm_pending_ = true;
         rebirth_audio_timer_ = REBIRTH_AUDIO_FRAMES;
         bgm_stage1_playing_ = false;
         bgm_stage2_playing_ = false;
         sfx_timer_ = REBIRTH_AUDIO_FRAMES;
-        load_sound_effect("boss_rebirth", "../sound/BOSS/rebirth.mp3");
-        play_sfx_boosted("boss_rebirth");
-        reset_position_to_center();
+        play_sfx_boosted(world, "boss_rebirth", "../sound/BOSS/rebirth.mp3");
+        reset_position_to_center(world);
         shots_.clear();
         lasers_.clear();
         fan_angle_offset_ = 0.0;
@@ -264,11 +205,11 @@ void Boss::enter_state(State new_state)
         state_limit_ = 10 * FPS;
         shots_.clear();
         vx_ = vy_ = 0.0;
-        fan_angle_offset_ = rnd(360) * PI / 180.0;
+        fan_angle_offset_ = world.rng.below(360) * PI / 180.0;
         break;
 
     case State::P2_Rest:
-        state_limit_ = rand_range(P2_REST_MIN, P2_REST_MAX);
+        state_limit_ = world.rng.range(P2_REST_MIN, P2_REST_MAX);
         break;
 
     case State::P2_LasersGrow:
@@ -279,19 +220,18 @@ void Boss::enter_state(State new_state)
         lasers_current_length_ = lasers_inner_radius_;
         for (int i = 0; i < 8; ++i)
             lasers_.push_back({ i * (PI / 4.0) });
-        reset_position_to_center();
+        reset_position_to_center(world);
         break;
 
     case State::P2_Lasers:
         lasers_timer_ = LASERS_DURATION_FRAMES;
         lasers_inner_radius_ = std::max(width, height) / 2.0 + 10.0;
         lasers_current_length_ = LASER_MAX_LENGTH;
-        reset_position_to_center();
+        reset_position_to_center(world);
         break;
 
     case State::PlayerLose:
-        load_sound_effect("boss_playerlose", "../sound/BOSS/player_lose.mp3");
-        play_sfx_boosted("boss_playerlose");
+        play_sfx_boosted(world, "boss_playerlose", "../sound/BOSS/player_lose.mp3");
         sfx_timer_ = SFX_PLAYERLOSE_FRAMES;
         player_lose_followup_pending_ = true;
         vx_ = vy_ = 0.0;
@@ -338,44 +278,44 @@ void Boss::fire_fan(int count, double speed)
     fan_angle_offset_ += delta;
 }
 
-void Boss::update_intro(player_data &player)
+void Boss::update_intro(GameWorld &world)
 {
-    play_stage1_bgm();
+    play_stage1_bgm(world);
 
-    double target_x = screen_width() / 2.0 - width / 2.0;
-    double target_y = screen_height() / 2.0 - height / 2.0;
+    double target_x = world.arena_w / 2.0 - width / 2.0;
+    double target_y = world.arena_h / 2.0 - height / 2.0;
     double speed    = 5.0;
 
-    if (std::fabs(x - target_x) > 1.0)
-        x += (x < target_x ? speed : -speed);
-    if (std::fabs(y - target_y) > 1.0)
-        y += (y < target_y ? speed : -speed);
+    // Walk in from wherever it spawned, landing exactly on the target
+    x += clamp(target_x - x, -speed, speed);
+    y += clamp(target_y - y, -speed, speed);
 
     if (std::fabs(x - target_x) <= 1.0 && std::fabs(y - target_y) <= 1.0)
     {
         if (state_timer_ == 0)
         {
-            load_sound_effect("boss_hit_player", "../sound/BOSS/hit_player.mp3");
-            play_sfx_boosted("boss_hit_player");
+            play_sfx_boosted(world, "boss_hit_player", "../sound/BOSS/hit_player.mp3");
         }
 
         if (++state_timer_ >= SFX_HIT_PLAYER_FRAMES)
         {
-            enter_state(State::P1_Fan);
+            enter_state(world, State::P1_Fan);
         }
     }
 }
 
-void Boss::update_p1_fan()
+void Boss::update_p1_fan(GameWorld &world)
 {
-    play_stage1_bgm();
+    play_stage1_bgm(world);
     if (fan_move_timer_ <= 0)
     {
-        double dx = rand_range(-60, 60);
-        double dy = rand_range(-60, 60);
-        x = clamp(x + dx, 0.0, screen_width() - width);
-        y = clamp(y + dy, 0.0, screen_height() - height);
-        fan_move_timer_ = rand_range(FPS - 20, FPS + 20);
+        double dx = world.rng.range(-60, 60);
+        double dy = world.rng.range(-60, 60);
+        double ox = x, oy = y;
+        x = clamp(x + dx, 0.0, world.arena_w - width);
+        y = clamp(y + dy, 0.0, world.arena_h - height);
+        world.obstacles->settle(ox, oy, x, y, width, height);
+        fan_move_timer_ = world.rng.range(FPS - 20, FPS + 20);
     }
     else
     {
@@ -389,76 +329,77 @@ void Boss::update_p1_fan()
 
     if (++state_timer_ >= state_limit_)
     {
-        enter_state(State::P1_Rest);
+        enter_state(world, State::P1_Rest);
     }
 }
 
-void Boss::update_p1_rest(player_data &player)
+void Boss::update_p1_rest(GameWorld &world)
 {
-    double target_x = player.player_x - width / 2.0;
-    double target_y = player.player_y - height / 2.0;
-    double dx = target_x - x;
-    double dy = target_y - y;
-    double dist = std::sqrt(dx * dx + dy * dy);
-    if (dist > 1.0)
+    FlowField::Step step = world.flow.sample(x + width / 2.0, y + height / 2.0); // Centre on the player
+    if (step.dist > 1.0)
     {
-        x += (dx / dist) * base_speed_;
-        y += (dy / dist) * base_speed_;
+        double speed = current_speed();
+        double ox = x, oy = y;
+        x += step.dx * speed;
+        y += step.dy * speed;
+        world.obstacles->settle(ox, oy, x, y, width, height);
     }
 
     if (++state_timer_ >= state_limit_)
     {
-        enter_state(State::P1_Fan);
+        enter_state(world, State::P1_Fan);
     }
 }
 
-void Boss::update_phase_half_cue()
+void Boss::update_phase_half_cue(GameWorld &world)
 {
     if (++state_timer_ >= state_limit_)
     {
         half_cue_played_ = true;
-        enter_state(state_before_cue_);
+        enter_state(world, state_before_cue_);
     }
 }
 
-void Boss::update_low_hp_cue()
+void Boss::update_low_hp_cue(GameWorld &world)
 {
     if (++state_timer_ >= state_limit_)
     {
         lowhp_cue_played_ = true;
-        enter_state(state_before_cue_);
+        enter_state(world, state_before_cue_);
     }
 }
 
-void Boss::update_phase1_death()
+void Boss::update_phase1_death(GameWorld &world)
 {
     if (++state_timer_ >= state_limit_)
     {
         phase1_finished_ = true;
-        enter_state(State::Rebirth);
+        enter_state(world, State::Rebirth);
     }
 }
 
-void Boss::update_rebirth()
+void Boss::update_rebirth(GameWorld &world)
 {
     if (++state_timer_ >= state_limit_)
     {
         phase_ = 2;
-        hp = max_hp_phase2_;
-        enter_state(State::P2_Fan);
+        hp = phase2_hp();
+        enter_state(world, State::P2_Fan);
     }
 }
 
-void Boss::update_p2_fan()
+void Boss::update_p2_fan(GameWorld &world)
 {
-    play_stage2_bgm();
+    play_stage2_bgm(world);
     if (fan_move_timer_ <= 0)
     {
-        double dx = rand_range(-60, 60);
-        double dy = rand_range(-60, 60);
-        x = clamp(x + dx, 0.0, screen_width() - width);
-        y = clamp(y + dy, 0.0, screen_height() - height);
-        fan_move_timer_ = rand_range(FPS - 20, FPS + 20);
+        double dx = world.rng.range(-60, 60);
+        double dy = world.rng.range(-60, 60);
+        double ox = x, oy = y;
+        x = clamp(x + dx, 0.0, world.arena_w - width);
+        y = clamp(y + dy, 0.0, world.arena_h - height);
+        world.obstacles->settle(ox, oy, x, y, width, height);
+        fan_move_timer_ = world.rng.range(FPS - 20, FPS + 20);
     }
     else
     {
@@ -472,88 +413,86 @@ void Boss::update_p2_fan()
 
     if (++state_timer_ >= state_limit_)
     {
-        if (rnd(100) < 50)
-            enter_state(State::P2_LasersGrow);
+        if (world.rng.below(100) < 50)
+            enter_state(world, State::P2_LasersGrow);
         else
-            enter_state(State::P2_Rest);
+            enter_state(world, State::P2_Rest);
     }
 }
 
-void Boss::update_p2_rest(player_data &player)
+void Boss::update_p2_rest(GameWorld &world)
 {
-    play_stage2_bgm();
-    double target_x = player.player_x - width / 2.0;
-    double target_y = player.player_y - height / 2.0;
-    double dx = target_x - x;
-    double dy = target_y - y;
-    double dist = std::sqrt(dx * dx + dy * dy);
-    if (dist > 1.0)
+    play_stage2_bgm(world);
+    FlowField::Step step = world.flow.sample(x + width / 2.0, y + height / 2.0); // Centre on the player
+    if (step.dist > 1.0)
     {
-        x += (dx / dist) * base_speed_;
-        y += (dy / dist) * base_speed_;
+        double speed = current_speed();
+        double ox = x, oy = y;
+        x += step.dx * speed;
+        y += step.dy * speed;
+        world.obstacles->settle(ox, oy, x, y, width, height);
     }
 
     if (++state_timer_ >= state_limit_)
     {
-        enter_state(State::P2_Fan);
+        enter_state(world, State::P2_Fan);
     }
 }
 
-void Boss::update_p2_lasers_grow(player_data &player)
+void Boss::update_p2_lasers_grow(GameWorld &world)
 {
-    play_stage2_bgm();
-    x += (screen_width() / 2.0 - width / 2.0 - x) * 0.12;
-    y += (screen_height() / 2.0 - height / 2.0 - y) * 0.12;
+    play_stage2_bgm(world);
+    x += (world.arena_w / 2.0 - width / 2.0 - x) * 0.12;
+    y += (world.arena_h / 2.0 - height / 2.0 - y) * 0.12;
 
     double growth_per = (LASER_MAX_LENGTH - lasers_inner_radius_) / LASER_GROW_FRAMES;
     lasers_current_length_ = std::min(LASER_MAX_LENGTH, lasers_current_length_ + growth_per);
 
-    update_lasers_damage(player);
+    update_lasers_damage(world);
 
     if (--lasers_grow_timer_ <= 0)
     {
-        enter_state(State::P2_Lasers);
+        enter_state(world, State::P2_Lasers);
         return;
     }
 }
 
-void Boss::update_p2_lasers(player_data &player)
+void Boss::update_p2_lasers(GameWorld &world)
 {
-    play_stage2_bgm();
+    play_stage2_bgm(world);
     lasers_current_length_ = LASER_MAX_LENGTH;
-    x += (screen_width() / 2.0 - width / 2.0 - x) * 0.12;
-    y += (screen_height() / 2.0 - height / 2.0 - y) * 0.12;
+    x += (world.arena_w / 2.0 - width / 2.0 - x) * 0.12;
+    y += (world.arena_h / 2.0 - height / 2.0 - y) * 0.12;
 
     for (auto &laser : lasers_)
         laser.ang += LASER_ROTATE_RATE;
 
-    update_lasers_damage(player);
+    update_lasers_damage(world);
 
     if (--lasers_timer_ <= 0)
     {
-        enter_state(State::P2_Rest);
+        enter_state(world, State::P2_Rest);
     }
 }
 
-void Boss::update_player_lose()
+void Boss::update_player_lose(GameWorld &world)
 {
     if (player_lose_followup_pending_ && --sfx_timer_ <= 0)
     {
-        load_sound_effect("boss_hit_player", "../sound/BOSS/hit_player.mp3");
-        play_sfx_boosted("boss_hit_player");
+        play_sfx_boosted(world, "boss_hit_player", "../sound/BOSS/hit_player.mp3");
         player_lose_followup_pending_ = false;
     }
 }
 
-void Boss::deal_damage_to_player(player_data &player)
+void Boss::deal_damage_to_player(GameWorld &world)
 {
+    player_data &player = world.player;
     if (player.damage_cooldown > 0 || player.blocking)
         return;
 
     if (player.hearts > 1)
     {
-        load_sound_effect("boss_hit_player", "../sound/BOSS/hit_player.mp3");
-        play_sfx_boosted("boss_hit_player");
+        play_sfx_boosted(world, "boss_hit_player", "../sound/BOSS/hit_player.mp3");
     }
 
     player.hearts -= 1;
@@ -564,36 +503,32 @@ void Boss::deal_damage_to_player(player_data &player)
     if (player.hearts == 0)
     {
         player.alive = false;
-        enter_state(State::PlayerLose);
+        enter_state(world, State::PlayerLose);
     }
 }
 
-void Boss::handle_player_collision(player_data &player)
+void Boss::handle_player_collision(GameWorld &world)
 {
+    player_data &player = world.player;
     if (contact_cooldown_ > 0)
     {
         --contact_cooldown_;
         return;
     }
 
-    double px = player.player_x;
-    double py = player.player_y;
     double pw = player.player_width;
     double ph = player.player_hight;
-
-    bool overlap = (px < x + width && px + pw > x && py < y + height && py + ph > y);
-    if (!overlap)
+    if (!strikes(player.player_x, player.player_y, pw, ph))
         return;
 
     if (player.blocking)
     {
-        load_sound_effect("block_sfx", "../sound/block.mp3");
-        play_sfx_boosted("block_sfx");
-        block_flash_timer = 8;
+        play_sfx_boosted(world, "block_sfx", "../sound/block.mp3");
+        world.block_flash_timer = 8;
     }
     else
     {
-        deal_damage_to_player(player);
+        deal_damage_to_player(world);
 
         double cx = x + width / 2.0;
         double cy = y + height / 2.0;
@@ -613,59 +548,40 @@ void Boss::handle_player_collision(player_data &player)
     contact_cooldown_ = 30;
 }
 
-void Boss::handle_player_bullets(std::vector<Bullet> &bullets)
+bool Boss::take_hit(GameWorld &world, int damage)
 {
     if (is_invulnerable_state())
-        return;
-
-    for (auto &b : bullets)
-    {
-        if (!b.active)
-            continue;
-
-        double prev_x = b.x - b.dx;
-        double prev_y = b.y - b.dy;
-        bool hit = point_in_rect(b.x, b.y, x, y, width, height) ||
-                   segment_intersects_rect(prev_x, prev_y, b.x, b.y, x, y, width, height);
-        if (!hit)
-            continue;
-
-        hp -= b.damage;
-        if (!b.piercing) b.active = false;
-
-        if (phase_ == 1 && !half_cue_played_ && hp <= max_hp_phase1_ / 2)
-        {
-            state_before_cue_ = State::P1_Fan;
-            enter_state(State::PhaseHalfCue);
-            return;
-        }
+        return false;
 
-        if (phase_ == 1 && !lowhp_cue_played_ && hp <= static_cast<int>(max_hp_phase1_ * 0.15))
-        {
-            state_before_cue_ = State::P1_Fan;
-            enter_state(State::LowHpCue);
-            return;
-        }
+    hp -= damage;
 
-        if (phase_ == 1 && hp <= 0 && !phase1_finished_)
-        {
-            hp = 0;
-            enter_state(State::Phase1Death);
-            return;
-        }
-
-        if (phase_ == 2 && hp <= 0)
-        {
-            hp = 0;
-            alive = false;
-            enter_state(State::DeadFinal);
-            return;
-        }
+    if (phase_ == 1 && !half_cue_played_ && hp <= phase1_hp() / 2)
+    {
+        state_before_cue_ = State::P1_Fan;
+        enter_state(world, State::PhaseHalfCue);
+    }
+    else if (phase_ == 1 && !lowhp_cue_played_ && hp <= static_cast<int>(phase1_hp() * 0.15))
+    {
+        state_before_cue_ = State::P1_Fan;
+        enter_state(world, State::LowHpCue);
+    }
+    else if (phase_ == 1 && hp <= 0 && !phase1_finished_)
+    {
+        hp = 0;
+        enter_state(world, State::Phase1Death);
     }
+    else if (phase_ == 2 && hp <= 0)
+    {
+        hp = 0;
+        alive = false;
+        enter_state(world, State::DeadFinal);
+    }
+    return true;
 }
 
-void Boss::update_projectiles(player_data &player)
+void Boss::update_projectiles(GameWorld &world)
 {
+    player_data &player = world.player;
     for (auto &shot : shots_)
     {
         if (!shot.active) continue;
@@ -683,6 +599,13 @@ void Boss::update_projectiles(player_data &player)
 
         if (!shot.active) continue;
 
+        // Walls and crates stop shots
+        if (world.obstacles->solid(shot.x, shot.y))
+        {
+            shot.active = false;
+            continue;
+        }
+
         double px = player.player_x + player.player_width / 2.0;
         double py = player.player_y + player.player_hight / 2.0;
         if (std::fabs(px - shot.x) < player.player_width / 2.0 &&
@@ -690,26 +613,26 @@ void Boss::update_projectiles(player_data &player)
         {
             if (player.blocking)
             {
-                load_sound_effect("block_sfx", "../sound/block.mp3");
-                play_sfx_boosted("block_sfx");
-                block_flash_timer = 8;
+                play_sfx_boosted(world, "block_sfx", "../sound/block.mp3");
+                world.block_flash_timer = 8;
             }
             else
             {
-                deal_damage_to_player(player);
+                deal_damage_to_player(world);
             }
             shot.active = false;
         }
     }
 
-    std::vector<BossBullet> alive;
-    alive.reserve(shots_.size());
-    for (auto &shot : shots_) if (shot.active) alive.push_back(shot);
-    shots_ = std::move(alive);
+    // Compact in place (keeps capacity, no per-frame allocation)
+    size_t kept = 0;
+    for (auto &shot : shots_) if (shot.active) shots_[kept++] = shot;
+    shots_.resize(kept);
 }
 
-void Boss::update_lasers_damage(player_data &player)
+void Boss::update_lasers_damage(GameWorld &world)
 {
+    player_data &player = world.player;
     double cx = x + width / 2.0;
     double cy = y + height / 2.0;
     double px = player.player_x + player.player_width / 2.0;
@@ -729,51 +652,72 @@ void Boss::update_lasers_damage(player_data &player)
         double nx = std::sin(laser.ang);
         double ny = -std::cos(laser.ang);
         double dist = std::fabs((px - cx) * nx + (py - cy) * ny);
-        if (dist < 14.0)
+        if (dist < LASER_REACH)
         {
             if (player.blocking)
             {
-                load_sound_effect("block_sfx", "../sound/block.mp3");
-                play_sfx_boosted("block_sfx");
-                block_flash_timer = 8;
+                play_sfx_boosted(world, "block_sfx", "../sound/block.mp3");
+                world.block_flash_timer = 8;
             }
             else
             {
-                deal_damage_to_player(player);
+                deal_damage_to_player(world);
             }
             return;
         }
     }
 }
 
-void Boss::reset_position_to_center()
+void Boss::collect_projectiles(std::vector<ProjectileInfo> &out) const
+{
+    for (const auto &shot : shots_)
+        if (shot.active)
+            out.push_back({shot.x, shot.y, shot.dx, shot.dy});
+}
+
+void Boss::collect_beams(std::vector<BeamInfo> &out) const
+{
+    if (state_ != State::P2_Lasers && state_ != State::P2_LasersGrow)
+        return;
+    double cx = x + width / 2.0;
+    double cy = y + height / 2.0;
+    double inner = lasers_inner_radius_;
+    double len = (state_ == State::P2_LasersGrow) ? lasers_current_length_ : LASER_MAX_LENGTH;
+    for (const auto &laser : lasers_)
+    {
+        double dirx = std::cos(laser.ang);
+        double diry = std::sin(laser.ang);
+        out.push_back({cx + dirx * inner, cy + diry * inner, cx + dirx * len, cy + diry * len, LASER_REACH});
+    }
+}
+
+void Boss::reset_position_to_center(const GameWorld &world)
 {
-    x = screen_width() / 2.0 - width / 2.0;
-    y = screen_height() / 2.0 - height / 2.0;
+    x = world.arena_w / 2.0 - width / 2.0;
+    y = world.arena_h / 2.0 - height / 2.0;
 }
 
-void Boss::update(player_data &player, std::vector<Bullet> &bullets)
+void Boss::update(GameWorld &world)
 {
     switch (state_)
     {
-    case State::Intro:           update_intro(player);           break;
-    case State::P1_Fan:          update_p1_fan();                break;
-    case State::P1_Rest:         update_p1_rest(player);         break;
-    case State::PhaseHalfCue:    update_phase_half_cue();        break;
-    case State::LowHpCue:        update_low_hp_cue();            break;
-    case State::Phase1Death:     update_phase1_death();          break;
-    case State::Rebirth:         update_rebirth();               break;
-    case State::P2_Fan:          update_p2_fan();                break;
-    case State::P2_Rest:         update_p2_rest(player);         break;
-    case State::P2_LasersGrow:   update_p2_lasers_grow(player);  break;
-    case State::P2_Lasers:       update_p2_lasers(player);       break;
-    case State::PlayerLose:      update_player_lose();           break;
+    case State::Intro:           update_intro(world);            break;
+    case State::P1_Fan:          update_p1_fan(world);           break;
+    case State::P1_Rest:         update_p1_rest(world);          break;
+    case State::PhaseHalfCue:    update_phase_half_cue(world);   break;
+    case State::LowHpCue:        update_low_hp_cue(world);       break;
+    case State::Phase1Death:     update_phase1_death(world);     break;
+    case State::Rebirth:         update_rebirth(world);          break;
+    case State::P2_Fan:          update_p2_fan(world);           break;
+    case State::P2_Rest:         update_p2_rest(world);          break;
+    case State::P2_LasersGrow:   update_p2_lasers_grow(world);   break;
+    case State::P2_Lasers:       update_p2_lasers(world);        break;
+    case State::PlayerLose:      update_player_lose(world);      break;
     case State::DeadFinal:                                       break;
     }
 
-    handle_player_collision(player);
-    handle_player_bullets(bullets);
-    update_projectiles(player);
+    handle_player_collision(world);
+    update_projectiles(world);
 
     if (stage2_bgm_pending_)
     {
@@ -782,76 +726,113 @@ void Boss::update(player_data &player, std::vector<Bullet> &bullets)
         if (rebirth_audio_timer_ <= 0 && phase_ == 2)
         {
             stage2_bgm_pending_ = false;
-            stop_active_sfx();
-            play_stage2_bgm(true);
+            stop_active_sfx(world);
+            play_stage2_bgm(world, true);
             rebirth_audio_timer_ = -1;
         }
     }
-
-    if (player.damage_cooldown > 0)
-        player.damage_cooldown--;
 }
 
-void Boss::draw() const
+int Boss::pose() const
 {
-    bitmap img = img_regular_;
     switch (state_)
     {
     case State::PhaseHalfCue:
-        img = (state_timer_ < 84) ? img_half0_ : img_half1_;
-        break;
+        return half_cue_clip.frame_at(state_timer_);
     case State::LowHpCue:
-        img = img_lowhp_;
-        break;
+        return SPRITE_LOWHP;
     case State::Phase1Death:
     case State::DeadFinal:
-        img = img_dead_;
-        break;
+        return SPRITE_DEAD;
     case State::Rebirth:
-        img = img_rebirth_;
-        break;
+        return SPRITE_REBIRTH;
     case State::PlayerLose:
-        img = img_player_lose_;
-        break;
+        return SPRITE_PLAYER_LOSE;
     default:
-        break;
+        return SPRITE_REGULAR;
     }
+}
 
-    if (img)
-        draw_bitmap(img, x, y);
-    else
-        fill_rectangle(enraged() ? COLOR_RED : COLOR_GRAY, x, y, width, height);
+void Boss::capture(const ViewRect &view, WorldLayer &out) const
+{
+    const EnemyArchetype &a = info();
+
+    // Off screen, only its shots and lasers can show. No health bar: the HUD
+    // has the boss bar
+    if (view.sees(x, y, width, height))
+        out.enemies.push_back({x, y, width, height, a.sprite(pose()), false, -1,
+                               enraged() ? COLOR_RED : COLOR_GRAY});
 
+    bitmap fan = a.sprite(SPRITE_BULLET_FAN);
     for (const auto &shot : shots_)
     {
-        if (!shot.active) continue;
-        double ang_deg = std::atan2(shot.dy, shot.dx) * 180.0 / PI;
+        if (!shot.active || !view.sees(shot.x, shot.y, 32)) continue;
         double local_x = shot.x - x;
         double local_y = shot.y - y;
         bool inside_sprite = (local_x >= 0 && local_x <= width && local_y >= 0 && local_y <= height);
         if (inside_sprite) continue;
 
-        if (img_bullet_fan_)
-            draw_bitmap(img_bullet_fan_, shot.x, shot.y, option_rotate_bmp(ang_deg));
-        else
-            fill_circle(COLOR_ORANGE, shot.x, shot.y, 4.0);
-    }
-
-    if (state_ == State::P2_Lasers || state_ == State::P2_LasersGrow)
-    {
-        double cx = x + width / 2.0;
-        double cy = y + height / 2.0;
-        double inner = lasers_inner_radius_;
-        double len = (state_ == State::P2_LasersGrow) ? lasers_current_length_ : LASER_MAX_LENGTH;
-        for (const auto &laser : lasers_)
+        if (fan)
         {
-            double dirx = std::cos(laser.ang);
-            double diry = std::sin(laser.ang);
-            double sx = cx + dirx * inner;
-            double sy = cy + diry * inner;
-            double ex = cx + dirx * len;
-            double ey = cy + diry * len;
-            draw_line(COLOR_RED, sx, sy, ex, ey, option_line_width(4));
+            SpriteView s;
+            s.image = fan;
+            s.x = shot.x;
+            s.y = shot.y;
+            s.step = rotation_step(shot.dx, shot.dy);
+            out.sprites.push_back(s);
         }
+        else
+            out.dots.push_back({COLOR_ORANGE, shot.x, shot.y, 4.0});
     }
+
+    // Lasers: the segments collect_beams reports, 4 px wide
+    static thread_local std::vector<BeamInfo> beams;
+    beams.clear();
+    collect_beams(beams);
+    for (const BeamInfo &b : beams)
+        out.lines.push_back({COLOR_RED, b.x0, b.y0, b.x1, b.y1, 4});
+}
+
+template <class Stream, class Self>
+void Boss::transfer(Stream &s, Self &self)
+{
+    s.field(self.phase_);
+    s.field(self.state_);
+    s.field(self.state_before_cue_);
+    s.field(self.state_timer_);
+    s.field(self.state_limit_);
+    s.field(self.lasers_timer_);
+    s.field(self.vx_);
+    s.field(self.vy_);
+    s.field(self.half_cue_played_);
+    s.field(self.lowhp_cue_played_);
+    s.field(self.phase1_finished_);
+    s.field(self.initial_p1_rest_done_);
+    s.field(self.stage2_bgm_pending_);
+    s.field(self.rebirth_audio_timer_);
+    s.field(self.player_lose_followup_pending_);
+    s.field(self.sfx_timer_);
+    s.field(self.fan_angle_offset_);
+    s.field(self.fan_move_timer_);
+    s.field(self.lasers_current_length_);
+    s.field(self.lasers_inner_radius_);
+    s.field(self.lasers_grow_timer_);
+    s.field(self.contact_cooldown_);
+    s.records(self.shots_);
+    s.items(self.lasers_);
+}
+
+void Boss::save_state(ByteWriter &w) const
+{
+    EnemyBase::save_state(w);
+    transfer(w, *this);
+}
+
+void Boss::load_state(ByteReader &r)
+{
+    EnemyBase::load_state(r);
+    transfer(r, *this);
+    // Music isn't part of the snapshot: let the current stage restart its track
+    bgm_stage1_playing_ = false;
+    bgm_stage2_playing_ = false;
 }
@@ -5,12 +5,17 @@
 class Boss : public EnemyBase
 {
 public:
-    Boss();
-    void load_assets() override;
-    void update(player_data &player, std::vector<Bullet> &bullets) override;
-    void draw() const override;
+    explicit Boss(int wave = 1) : EnemyBase(EnemyKind::Boss, wave) {}
+    void update(GameWorld &world) override;
+    bool take_hit(GameWorld &world, int damage) override;
+    void capture(const ViewRect &view, WorldLayer &out) const override;
+    void collect_projectiles(std::vector<ProjectileInfo> &out) const override;
+    void collect_beams(std::vector<BeamInfo> &out) const override;
+    int pose() const override;
+    void save_state(ByteWriter &w) const override;
+    void load_state(ByteReader &r) override;
 
-    int max_hp() const { return phase_ == 1 ? max_hp_phase1_ : max_hp_phase2_; }
+    int max_hp() const override { return phase_ == 1 ? phase1_hp() : phase2_hp(); }
     bool enraged() const { return phase_ == 2; }
 
 private:
@@ -37,7 +42,6 @@ private:
     int state_timer_ = 0;
     int state_limit_ = 0;
     int lasers_timer_ = 0;
-    double base_speed_ = 0.75;
     double vx_ = 0.0;
     double vy_ = 0.0;
     bool half_cue_played_ = false;
@@ -58,19 +62,8 @@ private:
     double lasers_inner_radius_ = 0.0;
     int lasers_grow_timer_ = 0;
 
-    int max_hp_phase1_ = 12000;
-    int max_hp_phase2_ = static_cast<int>(12000 * 1.5);
     int contact_cooldown_ = 0;
 
-    bitmap img_regular_{nullptr};
-    bitmap img_half0_{nullptr};
-    bitmap img_half1_{nullptr};
-    bitmap img_lowhp_{nullptr};
-    bitmap img_dead_{nullptr};
-    bitmap img_rebirth_{nullptr};
-    bitmap img_player_lose_{nullptr};
-    bitmap img_bullet_fan_{nullptr};
-
     struct BossBullet
     {
         double x;
@@ -79,6 +72,12 @@ private:
         double dy;
         int life;
         bool active;
+
+        template <class Stream, class Self>
+        static void transfer(Stream &s, Self &b)
+        {
+            s.field(b.x); s.field(b.y); s.field(b.dx); s.field(b.dy); s.field(b.life); s.field(b.active);
+        }
     };
 
     struct Laser
@@ -89,30 +88,36 @@ private:
     std::vector<BossBullet> shots_;
     std::vector<Laser> lasers_;
 
-    void enter_state(State new_state);
+    int phase1_hp() const { return EnemyBase::max_hp(); } // The archetype's hp
+    int phase2_hp() const;
+
+    void enter_state(GameWorld &world, State new_state);
     bool is_invulnerable_state() const;
-    void play_stage1_bgm(bool force_restart = false);
-    void play_stage2_bgm(bool force_restart = false);
-    void stop_active_sfx();
+    void play_stage1_bgm(GameWorld &world, bool force_restart = false);
+    void play_stage2_bgm(GameWorld &world, bool force_restart = false);
+    void stop_active_sfx(GameWorld &world);
     void fire_fan(int count, double speed);
 
-    void update_intro(player_data &player);
-    void update_p1_fan();
-    void update_p1_rest(player_data &player);
-    void update_phase_half_cue();
-    void update_low_hp_cue();
-    void update_phase1_death();
-    void update_rebirth();
-    void update_p2_fan();
-    void update_p2_rest(player_data &player);
-    void update_p2_lasers_grow(player_data &player);
-    void update_p2_lasers(player_data &player);
-    void update_player_lose();
-
-    void deal_damage_to_player(player_data &player);
-    void handle_player_collision(player_data &player);
-    void handle_player_bullets(std::vector<Bullet> &bullets);
-    void update_projectiles(player_data &player);
-    void update_lasers_damage(player_data &player);
-    void reset_position_to_center();
+    void update_intro(GameWorld &world);
+    void update_p1_fan(GameWorld &world);
+    void update_p1_rest(GameWorld &world);
+    void update_phase_half_cue(GameWorld &world);
+    void update_low_hp_cue(GameWorld &world);
+    void update_phase1_death(GameWorld &world);
+    void update_rebirth(GameWorld &world);
+    void update_p2_fan(GameWorld &world);
+    void update_p2_rest(GameWorld &world);
+    void update_p2_lasers_grow(GameWorld &world);
+    void update_p2_lasers(GameWorld &world);
+    void update_player_lose(GameWorld &world);
+
+    void deal_damage_to_player(GameWorld &world);
+    void handle_player_collision(GameWorld &world);
+    void update_projectiles(GameWorld &world);
+    void update_lasers_damage(GameWorld &world);
+    void reset_position_to_center(const GameWorld &world);
+
+    // Fields shared by save_state/load_state (Stream is ByteWriter or ByteReader)
+    template <class Stream, class Self>
+    static void transfer(Stream &s, Self &self);
 };
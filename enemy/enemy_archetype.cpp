@@ -0,0 +1,181 @@
+// Enemy archetypes: enemies.def parser, frame boxes, scaling curves and sprite loading
+#include "enemy_archetype.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    struct Table
+    {
+        std::vector<EnemyArchetype> rows; // Indexed by EnemyKind
+        std::vector<bool> defined;
+        std::string error;
+    };
+
+    bool fail(Table &table, int line, const std::string &msg)
+    {
+        table.error = std::string(kEnemyDefsPath) + ":" + std::to_string(line) + ": " + msg;
+        table.rows.clear();
+        return false;
+    }
+
+    // Apply one "key values..." line to `a`; false on an unknown key or bad value
+    bool parse_key(EnemyArchetype &a, const std::string &key, std::istringstream &in)
+    {
+        if (key == "size") in >> a.width >> a.height;
+        else if (key == "hp") in >> a.hp;
+        else if (key == "speed") in >> a.speed;
+        else if (key == "scale") in >> a.hp_per_wave >> a.speed_per_wave;
+        else if (key == "slow") in >> a.slow_time >> a.slow_factor;
+        else if (key == "coins") in >> a.coin_min >> a.coin_rand;
+        else if (key == "variants") in >> a.variants;
+        else if (key == "sprite")
+        {
+            std::string k, path;
+            if (!(in >> k >> path) || (int)a.sprite_keys.size() == kMaxEnemySprites)
+                return false;
+            a.sprite_keys.push_back(k);
+            a.sprite_paths.push_back(path);
+            a.frames.emplace_back();
+        }
+        else if (key == "hurtbox" || key == "hitbox")
+        {
+            // Boxes of the sprite on the line before
+            int x = 0, y = 0, w = 0, h = 0;
+            if (a.frames.empty() || !(in >> x >> y >> w >> h) || w <= 0 || h <= 0)
+                return false;
+            FrameBox &box = key == "hurtbox" ? a.frames.back().hurt : a.frames.back().hit;
+            box = {(int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h};
+            // A hitbox may reach past the sprite (a swing), a hurtbox may not
+            return key == "hitbox" || (x >= 0 && y >= 0 && x + w <= a.width && y + h <= a.height);
+        }
+        else return false;
+        return !in.fail();
+    }
+
+    // One FrameBoxes per pose; a pose without a hurtbox is hurt anywhere on
+    // its sprite. False if boxes were given past the first sprite set.
+    bool build_frames(EnemyArchetype &a)
+    {
+        const size_t poses = a.sprite_keys.size() / a.variants;
+        for (size_t i = poses; i < a.frames.size(); ++i)
+            if (a.frames[i].hurt.w != 0 || a.frames[i].hit.w != 0)
+                return false;
+        a.frames.resize(std::max<size_t>(poses, 1));
+        for (FrameBoxes &f : a.frames)
+            if (f.hurt.w == 0)
+                f.hurt = {0, 0, (int16_t)a.width, (int16_t)a.height};
+        return true;
+    }
+
+    // Stats for every level, so a lookup is one array read
+    void build_curves(EnemyArchetype &a)
+    {
+        for (int i = 0; i < kMaxEnemyLevel; ++i)
+        {
+            a.hp_curve[i] = (int)(a.hp * (1.0 + a.hp_per_wave * i));
+            a.speed_curve[i] = a.speed * (1.0 + a.speed_per_wave * i);
+        }
+    }
+
+    bool load(Table &table, const char *path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+            return fail(table, 0, "cannot open");
+
+        table.rows.assign(kEnemyKinds, EnemyArchetype());
+        table.defined.assign(kEnemyKinds, false);
+        EnemyArchetype cur;
+        bool in_block = false;
+        std::string raw;
+        for (int line = 1; std::getline(file, raw); ++line)
+        {
+            std::istringstream in(raw.substr(0, raw.find('#')));
+            std::string key;
+            if (!(in >> key))
+                continue;
+
+            if (key == "enemy")
+            {
+                int id = -1;
+                std::string name;
+                if (in_block || !(in >> id >> name) || id < 0 || id >= kEnemyKinds)
+                    return fail(table, line, "expected 'enemy <id 0-" + std::to_string(kEnemyKinds - 1) +
+                                                 "> <name>' outside a block");
+                if (table.defined[id])
+                    return fail(table, line, "duplicate enemy id " + std::to_string(id));
+                cur = EnemyArchetype();
+                cur.kind = (EnemyKind)id;
+                cur.name = name;
+                in_block = true;
+            }
+            else if (key == "end")
+            {
+                if (!in_block)
+                    return fail(table, line, "'end' without 'enemy'");
+                if (cur.hp < 1 || cur.width <= 0 || cur.height <= 0 || cur.coin_rand < 1 || cur.variants < 1 ||
+                    cur.sprite_keys.size() % cur.variants != 0)
+                    return fail(table, line, cur.name + " needs positive hp, size and coin range, and whole sprite sets");
+                if (!build_frames(cur))
+                    return fail(table, line, cur.name + ": hurtbox/hitbox lines belong to the first sprite set");
+                build_curves(cur);
+                table.rows[(int)cur.kind] = cur;
+                table.defined[(int)cur.kind] = true;
+                in_block = false;
+            }
+            else if (!in_block || !parse_key(cur, key, in))
+            {
+                return fail(table, line, "bad line '" + key + "'");
+            }
+        }
+        if (in_block)
+            return fail(table, 0, "missing 'end'");
+        for (int id = 0; id < kEnemyKinds; ++id)
+            if (!table.defined[id])
+                return fail(table, 0, "enemy id " + std::to_string(id) + " not defined");
+        return true;
+    }
+
+    // Parsed on first use (thread-safe), never reloaded
+    Table &table()
+    {
+        static Table t = [] {
+            Table r;
+            load(r, kEnemyDefsPath);
+            return r;
+        }();
+        return t;
+    }
+}
+
+const EnemyArchetype &enemy_archetype(EnemyKind kind)
+{
+    return table().rows[(int)kind];
+}
+
+bool find_enemy_kind(const std::string &name, EnemyKind &out)
+{
+    for (const EnemyArchetype &a : table().rows)
+        if (a.name == name)
+        {
+            out = a.kind;
+            return true;
+        }
+    return false;
+}
+
+void load_enemy_sprites(EnemyKind kind)
+{
+    EnemyArchetype &a = table().rows[(int)kind];
+    if (!a.sprites.empty())
+        return;
+    for (size_t i = 0; i < a.sprite_keys.size(); ++i)
+        a.sprites.push_back(load_bitmap(a.sprite_keys[i], a.sprite_paths[i]));
+}
+
+const std::string &enemy_defs_error()
+{
+    return table().error;
+}
@@ -0,0 +1,86 @@
+// Enemy archetypes: per-kind stats, size, sprites, per-frame collision boxes
+// and wave scaling, read once from enemy/enemies.def into a table indexed by
+// EnemyKind. An enemy keeps only its kind, the wave level it was spawned for
+// and its dynamic state; everything constant about it is looked up here.
+#pragma once
+#include "splashkit.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const char *const kEnemyDefsPath = "enemy/enemies.def";
+const int kMaxEnemyLevel = 64; // Waves past this one reuse its stats
+const int kMaxEnemySprites = 32;
+
+// Concrete enemy type, stable across builds (stored in world snapshots)
+enum class EnemyKind : uint8_t
+{
+    Slime,
+    HilichurlMelee,
+    HilichurlArcher,
+    Boss
+};
+const int kEnemyKinds = 4;
+
+// Collision box in sprite pixels, from the top-left of the sprite as stored
+// (an enemy drawn mirrored mirrors its boxes too); w == 0 means none
+struct FrameBox
+{
+    int16_t x = 0, y = 0, w = 0, h = 0;
+};
+
+// Boxes of one animation frame: where the enemy can be hit (hurt) and where
+// its attack lands on the player (hit; none on frames that do no damage)
+struct FrameBoxes
+{
+    FrameBox hurt, hit;
+};
+
+// One archetype (see enemies.def for the meaning of each key)
+struct EnemyArchetype
+{
+    EnemyKind kind = EnemyKind::Slime;
+    std::string name;                 // Name used by waves.def
+
+    double width = 64, height = 64;   // Body size (the sprite size): movement, drawing
+    int hp = 100;                     // Health at wave 1
+    double speed = 0.5;               // Pixels per frame at wave 1
+    double hp_per_wave = 0;           // Growth per wave after the first,
+    double speed_per_wave = 0;        // as a fraction of the wave-1 value
+    int slow_time = 0;                // Frames slowed after a hit
+    double slow_factor = 1.0;         // Speed kept while slowed
+    int coin_min = 0, coin_rand = 1;  // Drop worth coin_min + rng.below(coin_rand)
+
+    std::vector<std::string> sprite_keys, sprite_paths; // In file order
+    int variants = 1;                 // Sprites split into this many equal sets
+    std::vector<bitmap> sprites;      // Filled by load_enemy_sprites
+    std::vector<FrameBoxes> frames;   // Per pose: the sprites of the first set
+
+    int hp_curve[kMaxEnemyLevel];     // Scaled stats per level (level 1 first)
+    double speed_curve[kMaxEnemyLevel];
+
+    int hp_at(int level) const { return hp_curve[clamp_level(level)]; }
+    double speed_at(int level) const { return speed_curve[clamp_level(level)]; }
+
+    // Sprites per variant, and sprite i of variant v
+    int sprites_per_variant() const { return (int)sprites.size() / variants; }
+    bitmap sprite(int i, int v = 0) const { return sprites.empty() ? nullptr : sprites[v * sprites_per_variant() + i]; }
+
+    // Collision boxes of pose `i` (shared by every sprite set: sets only
+    // change the look)
+    const FrameBoxes &frame(int i) const { return frames[i < (int)frames.size() ? i : 0]; }
+
+private:
+    static int clamp_level(int level) { return level < 1 ? 0 : level > kMaxEnemyLevel ? kMaxEnemyLevel - 1 : level - 1; }
+};
+
+const EnemyArchetype &enemy_archetype(EnemyKind kind);
+
+// Kind whose archetype is called `name`; false if there is none
+bool find_enemy_kind(const std::string &name, EnemyKind &out);
+
+// Load the sprites of `kind` (once; later calls return at once)
+void load_enemy_sprites(EnemyKind kind);
+
+// Empty when enemies.def loaded, else "file:line: message"
+const std::string &enemy_defs_error();
@@ -2,27 +2,165 @@
 #include "splashkit.h"
 #include "../player/player.hpp"
 #include "../weapon/weapon_base.hpp"
+#include "../game/snapshot.hpp"
+#include "../game/camera.hpp"
+#include "../game/anim_clip.hpp"
+#include "enemy_archetype.hpp"
+#include "sprite_mask.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
+struct GameWorld;
+struct WorldLayer; // render/world_layer.hpp
+
+// Hostile projectile as seen from outside its owner (bots, training envs)
+struct ProjectileInfo
+{
+    double x, y;   // Position
+    double dx, dy; // Velocity per frame
+};
+
+// Hostile beam (the boss's lasers) as seen from outside its owner: it hurts
+// the player whose centre comes within `reach` of the segment
+struct BeamInfo
+{
+    double x0, y0; // Segment start
+    double x1, y1; // and end
+    double reach;
+};
+
+// Collision box in arena coordinates (w == 0: none)
+struct HitRect
+{
+    double x = 0, y = 0, w = 0, h = 0;
+
+    // Whether it overlaps the box (bx, by, bw, bh); touching edges do not
+    bool overlaps(double bx, double by, double bw, double bh) const
+    {
+        return w > 0 && bx < x + w && bx + bw > x && by < y + h && by + bh > y;
+    }
+};
+
 // Abstract base class for all enemies
 class EnemyBase
 {
 public:
     double x{0}, y{0};          // X and Y coordinates
-    double width{0}, height{0}; // Width and height
+    double width{0}, height{0}; // Body size, copied from the archetype (read every tick)
     int hp{0};                  // Health points
+    int slow_timer = 0;         // Frames of on-hit slow left
     bool alive{true};           // Alive status
-    int slow_timer = 20;        // Slow effect timer
-    int speed = 0.5;            // Movement speed
-    int slow_factor = 0.5;      // Slow effect factor
+    uint8_t level = 1;          // Wave the stats are scaled for
+
+    // Archetype row `kind`, scaled for `wave`
+    EnemyBase(EnemyKind kind, int wave)
+        : kind_(kind)
+    {
+        const EnemyArchetype &a = info();
+        width = a.width;
+        height = a.height;
+        level = (uint8_t)(wave < 1 ? 1 : wave > kMaxEnemyLevel ? kMaxEnemyLevel : wave);
+        hp = a.hp_at(level);
+    }
     virtual ~EnemyBase() = default;
 
-    // Load own assets for each enemy
-    virtual void load_assets() = 0;
+    EnemyKind kind() const { return kind_; }
+    const EnemyArchetype &info() const { return enemy_archetype(kind_); }
+
+    // Full health, for HP bars
+    virtual int max_hp() const { return info().hp_at(level); }
+
+    // Movement speed this frame; counts down the on-hit slow
+    double current_speed()
+    {
+        double s = info().speed_at(level);
+        if (slow_timer > 0)
+        {
+            s *= info().slow_factor;
+            slow_timer--;
+        }
+        return s;
+    }
+
+    // Load the archetype's sprites (shared, loaded once per kind)
+    virtual void load_assets() { load_enemy_sprites(kind_); }
+
+    // Roll per-instance looks from the world's generator, once when it
+    // spawns (never on a snapshot restore, which loads them instead)
+    virtual void on_spawn(GameWorld &world) { (void)world; }
+
+    // Update per frame (AI behavior, movement, attacks)
+    virtual void update(GameWorld &world) = 0;
+
+    // Apply one player hit (bullet or hitscan ray, resolved by update_world
+    // and the weapons). False when the hit does not land (e.g. the boss
+    // between phases) and the shot passes through.
+    virtual bool take_hit(GameWorld &world, int damage) = 0;
+
+    // Add its body, health bar, shots and effects to the render snapshot's
+    // world layer (arena coordinates); parts outside `view` are skipped
+    virtual void capture(const ViewRect &view, WorldLayer &out) const = 0;
+
+    // Animation frame showing now, as a pose of the archetype (selects the
+    // frame's collision boxes), and whether its sprite is drawn mirrored
+    virtual int pose() const { return 0; }
+    virtual bool mirrored() const { return false; }
+
+    // Where the current frame can be hit / lands its attack (no hitbox on
+    // frames that do no damage)
+    HitRect hurtbox() const { return place(info().frame(pose()).hurt); }
+    HitRect hitbox() const { return place(info().frame(pose()).hit); }
+
+    // The current frame's pixel mask (placed at x, y), nullptr when its boxes
+    // are exact
+    const SpriteMask *mask() const { return enemy_mask(kind_, pose(), mirrored()); }
+
+    // Whether the current frame's attack lands on the box (bx, by, bw, bh):
+    // the hitbox overlaps it and, for a hitbox on the sprite, so do opaque
+    // pixels. A hitbox reaching past the sprite (a swing) is an area of
+    // effect and needs only the box overlap.
+    bool strikes(double bx, double by, double bw, double bh) const
+    {
+        const HitRect hit = hitbox();
+        if (!hit.overlaps(bx, by, bw, bh))
+            return false;
+        const SpriteMask *m = mask();
+        if (!m || hit.x < x || hit.y < y || hit.x + hit.w > x + m->width() || hit.y + hit.h > y + m->height())
+            return true;
+        return m->any_in((int)std::floor(std::max(hit.x, bx) - x), (int)std::floor(std::max(hit.y, by) - y),
+                         (int)std::ceil(std::min(hit.x + hit.w, bx + bw) - x),
+                         (int)std::ceil(std::min(hit.y + hit.h, by + bh) - y));
+    }
+
+    // Frame box `b` placed at the enemy's position
+    HitRect place(const FrameBox &b) const
+    {
+        double bx = mirrored() ? width - b.x - b.w : b.x;
+        return {x + bx, y + b.y, (double)b.w, (double)b.h};
+    }
+
+    // Winding up a blockable attack right now (lets scripted players react)
+    virtual bool telegraphing() const { return false; }
+
+    // Append this enemy's live projectiles to `out`
+    virtual void collect_projectiles(std::vector<ProjectileInfo> &out) const { (void)out; }
+
+    // Append this enemy's live beams to `out`
+    virtual void collect_beams(std::vector<BeamInfo> &out) const { (void)out; }
 
-    // Update per frame (AI behavior, movement, taking damage)
-    virtual void update(player_data &player, std::vector<Bullet> &bullets) = 0;
+    // Snapshot support: everything update() depends on (not bitmaps).
+    // Overrides call the base version first, then add their own state.
+    virtual void save_state(ByteWriter &w) const
+    {
+        w.field(x); w.field(y); w.field(hp); w.field(slow_timer); w.field(alive); w.field(level);
+    }
+    virtual void load_state(ByteReader &r)
+    {
+        r.field(x); r.field(y); r.field(hp); r.field(slow_timer); r.field(alive); r.field(level);
+    }
 
-    // Draw itself
-    virtual void draw() const = 0;
+private:
+    EnemyKind kind_; // Archetype index
 };
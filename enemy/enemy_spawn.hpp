@@ -3,135 +3,117 @@
 #include <memory>
 #include "enemy_base.hpp"
 #include "slime/slime.hpp"
-
-// Wave spawn tracking (exposed for HUD)
-inline int g_spawn_timer = 0;
-inline int g_last_wave = -1;
-inline int g_spawned_this_wave = 0;
-inline int g_max_in_this_wave = 0;
 #include "hilichurl/hilichurl_melee.hpp"
 #include "hilichurl/hilichurl_archer.hpp"
 #include "boss/boss.hpp"
+#include "wave_schedule.hpp"
+#include "../game/game_world.hpp"
 
-// Enemy spawning logic (simple waves)
-inline void spawn_enemies(std::vector<std::unique_ptr<EnemyBase>> &enemies,
-                          int wave,
-                          bool &wave_in_progress)
+// Construct an enemy of the given kind, scaled for `wave` (no assets loaded)
+inline std::unique_ptr<EnemyBase> create_enemy(EnemyKind kind, int wave = 1)
 {
-    // State (preserves info across frames)
-    int &spawn_timer = g_spawn_timer;
-    int &last_wave = g_last_wave;
-    int &spawned_this_wave = g_spawned_this_wave;
-
-    // Parameter configuration
-    const int spawn_interval = 60;              // Attempt to spawn an enemy every 60 frames
-    const int max_in_screen = 10;               // Max enemies on screen simultaneously
-    int max_in_this_wave = (wave==5 ? 1 : 10 + (wave - 1) * 8); // Wave 5: Boss only
-
-    if (max_in_this_wave > 200)
-        max_in_this_wave = 200;
-    g_max_in_this_wave = max_in_this_wave;
-
-    // Reset when new wave starts
-    if (wave != last_wave)
+    switch (kind)
     {
-        last_wave = wave;
-        spawn_timer = 0;
-        spawned_this_wave = 0;
+    case EnemyKind::Slime:           return std::make_unique<SlimeEnemy>(wave);
+    case EnemyKind::HilichurlMelee:  return std::make_unique<HilichurlMelee>(wave);
+    case EnemyKind::HilichurlArcher: return std::make_unique<HilichurlArcher>(wave);
+    case EnemyKind::Boss:            return std::make_unique<Boss>(wave);
     }
+    return nullptr;
+}
 
-    // Count currently alive enemies
-    int alive_count = 0;
-    for (auto &e : enemies)
-        if (e->alive)
-            alive_count++;
-
-    // Check if wave is complete
-    bool all_spawned = (spawned_this_wave >= max_in_this_wave);
-    if (all_spawned && alive_count == 0)
+// Place one enemy of a spawn event just outside the view
+inline void spawn_one(GameWorld &world, const WaveInfo &info, const SpawnEvent &ev)
+{
+    EnemyKind kind = ev.mixed ? info.pick(world.rng.below(info.mix_upto[info.mix_count - 1])) : ev.kind;
+    std::unique_ptr<EnemyBase> enemy = create_enemy(kind, world.wave);
+    enemy->on_spawn(world); // Headless too: the rolls keep the run's sequence
+    if (!world.headless)
+        enemy->load_assets();
+
+    const ViewRect view = camera_view(world);
+    double w = view.w;
+    double h = view.h;
+    SpawnEdge edge = ev.edge == SpawnEdge::Any ? (SpawnEdge)world.rng.below(4) : ev.edge;
+    switch (edge)
     {
-        wave_in_progress = false; // Current wave ends
-        return;
+    case SpawnEdge::Top:
+        enemy->x = world.rng.below(static_cast<int>(w) - 48);
+        enemy->y = -48;
+        break;
+    case SpawnEdge::Right:
+        enemy->x = w + 48;
+        enemy->y = world.rng.below(static_cast<int>(h) - 48);
+        break;
+    case SpawnEdge::Bottom:
+        enemy->x = world.rng.below(static_cast<int>(w) - 48);
+        enemy->y = h + 48;
+        break;
+    case SpawnEdge::Left:
+        enemy->x = -48;
+        enemy->y = world.rng.below(static_cast<int>(h) - 48);
+        break;
+    case SpawnEdge::Any:
+    case SpawnEdge::TopCentre:
+        enemy->x = w / 2.0 - enemy->width / 2.0;
+        enemy->y = -enemy->height - 40.0;
+        break;
     }
+    enemy->x += view.x;
+    enemy->y += view.y;
 
-    // Special Boss wave: spawn immediately and only once; finish when dead
-    if (wave == 5)
+    world.enemies.push_back(std::move(enemy));
+    world.spawn.spawned_this_wave++;
+    world.spawn.alive++;
+}
+
+// The current wave's timeline: from waves.def, or generated in endless mode
+inline const WaveInfo *current_wave_info(GameWorld &world)
+{
+    if (!world.endless)
+        return wave_info(world.wave);
+    if (world.endless_built != world.wave)
     {
-        if (spawned_this_wave == 0)
-        {
-            auto boss = std::make_unique<Boss>();
-            boss->load_assets();
-            boss->x = screen_width() / 2.0 - boss->width / 2.0;
-            boss->y = -boss->height - 40.0;
-            enemies.push_back(std::move(boss));
-            spawned_this_wave = 1;
-        }
-        // Check completion
-        int alive_boss = 0; for (auto &e : enemies) if (e->alive) alive_boss++;
-        if (alive_boss == 0) { wave_in_progress = false; }
-        return;
+        build_endless_wave(world.wave, world.endless_wave);
+        world.endless_built = world.wave;
     }
+    return &world.endless_wave;
+}
 
-    // Control spawn timing
-    spawn_timer++;
-    if (spawn_timer < spawn_interval)
-        return;      // Interval not reached
-    spawn_timer = 0; // Reset timer
-
-    if (alive_count >= max_in_screen)
-        return; // Too many on screen, don't spawn
-    if (spawned_this_wave >= max_in_this_wave)
-        return; // Already spawned enough
-
-    // Randomly determine enemy type to spawn by wave
-    int type = rnd(100); // 0..99
+// Enemy spawning: advance the current wave's timeline (see wave_schedule.hpp)
+inline void spawn_enemies(GameWorld &world)
+{
+    SpawnState &s = world.spawn;
+    const WaveInfo *info = current_wave_info(world);
 
-    std::unique_ptr<EnemyBase> enemy;
-    if (wave <= 1)
-    {
-        // Wave 1: Slime 60%, Melee 40%
-        if (type < 60) enemy = std::make_unique<SlimeEnemy>();
-        else enemy = std::make_unique<HilichurlMelee>();
-    }
-    else
+    // Reset when new wave starts
+    if (world.wave != s.last_wave)
     {
-        // Wave 2+: Slime 55%, Melee 35%, Archer 10% (reduce archers)
-        if (type < 55) enemy = std::make_unique<SlimeEnemy>();
-        else if (type < 90) enemy = std::make_unique<HilichurlMelee>();
-        else enemy = std::make_unique<HilichurlArcher>();
+        s.last_wave = world.wave;
+        s.timer = 0;
+        s.cursor = 0;
+        s.spawned_this_wave = 0;
+        s.max_in_this_wave = info ? info->total : 0;
     }
 
-    enemy->load_assets();
-
-    // Random spawn outside screen edges
-    double w = screen_width();
-    double h = screen_height();
-    double x, y;
-    int side = rnd(4); // 0=top, 1=right, 2=bottom, 3=left
-
-    switch (side)
+    // Wave complete: timeline done and everything it spawned is dead
+    const int events = info ? (int)info->timeline.size() : 0;
+    if (s.cursor >= events)
     {
-    case 0:
-        x = rnd(w - 48);
-        y = -48;
-        break;
-    case 1:
-        x = w + 48;
-        y = rnd(h - 48);
-        break;
-    case 2:
-        x = rnd(w - 48);
-        y = h + 48;
-        break;
-    case 3:
-        x = -48;
-        y = rnd(h - 48);
-        break;
+        if (s.alive == 0)
+            world.wave_in_progress = false;
+        return;
     }
 
-    enemy->x = x;
-    enemy->y = y;
-
-    enemies.push_back(std::move(enemy));
-    spawned_this_wave++;
+    // Control spawn timing
+    const SpawnEvent &ev = info->timeline[s.cursor];
+    if (++s.timer < ev.wait)
+        return;      // Wait not over
+    s.timer = 0;
+    if (s.alive >= info->max_alive)
+        return;      // Too many on screen, try again after another wait
+
+    s.cursor++;
+    for (int n = 0; n < ev.count; ++n)
+        spawn_one(world, *info, ev);
 }
@@ -7,31 +7,46 @@
 class HilichurlArcher : public EnemyBase
 {
 public:
-    HilichurlArcher() {}
+    explicit HilichurlArcher(int wave = 1) : EnemyBase(EnemyKind::HilichurlArcher, wave)
+    {
+        reload_timer_ = reload_time_;
+    }
 
-    void load_assets() override;
-    void update(player_data &player, std::vector<Bullet> &bullets) override;
-    void draw() const override;
+    void update(GameWorld &world) override;
+    bool take_hit(GameWorld &world, int damage) override;
+    void capture(const ViewRect &view, WorldLayer &out) const override;
+    void collect_projectiles(std::vector<ProjectileInfo> &out) const override;
+    int pose() const override { return is_loaded_ ? 1 : 0; }
+    bool mirrored() const override { return facing_left_; }
+    void save_state(ByteWriter &w) const override;
+    void load_state(ByteReader &r) override;
 
 private:
-    // Visuals
-    bitmap unloaded_{nullptr};
-    bitmap loaded_{nullptr};
+    // Visuals (sprites: unloaded, loaded, arrow)
     bool is_loaded_ = false;
     bool facing_left_ = false;
 
     // Movement
-    double speed_ = 0.4;
-    const double prefer_dist_ = 300.0;
-    const double min_dist_ = 240.0;
+    static constexpr double prefer_dist_ = 300.0;
+    static constexpr double min_dist_ = 240.0;
 
     // Loading / firing
     int reload_timer_ = 0;
-    const int reload_time_ = 150; // slower fire rate
+    static const int reload_time_ = 150; // slower fire rate
     int loaded_display_timer_ = 0;
-    const int loaded_display_time_ = 20;
+    static const int loaded_display_time_ = 20;
 
     // Simple enemy projectile (arrow) container
-    struct Arrow { double x,y,dx,dy; bool active; };
+    struct Arrow
+    {
+        double x,y,dx,dy; bool active;
+
+        template <class Stream, class Self>
+        static void transfer(Stream &s, Self &a) { s.field(a.x); s.field(a.y); s.field(a.dx); s.field(a.dy); s.field(a.active); }
+    };
     std::vector<Arrow> arrows_;
+
+    // Fields shared by save_state/load_state (Stream is ByteWriter or ByteReader)
+    template <class Stream, class Self>
+    static void transfer(Stream &s, Self &self);
 };
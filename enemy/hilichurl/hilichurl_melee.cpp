@@ -3,70 +3,21 @@
 #include "player/player.hpp"
 #include "weapon/weapon_base.hpp"
 #include "coin.hpp"
+#include "game/game_world.hpp"
+#include "game/audio.hpp"
+#include "render/world_layer.hpp"
 #include <cmath>
 #include <cstdlib>
 
-extern player_data player; // from main.cpp
-
-// Helpers for robust bullet collision (avoid tunneling)
-static inline bool h_point_in_rect(double px, double py, double rx, double ry, double rw, double rh)
-{
-    return (px >= rx && px <= rx + rw && py >= ry && py <= ry + rh);
-}
-
-static bool h_segment_intersects_rect(double x1, double y1, double x2, double y2,
-                                      double rx, double ry, double rw, double rh)
-{
-    if (h_point_in_rect(x1, y1, rx, ry, rw, rh) || h_point_in_rect(x2, y2, rx, ry, rw, rh))
-        return true;
-
-    auto seg_intersect = [](double ax, double ay, double bx, double by,
-                            double cx, double cy, double dx, double dy) -> bool {
-        auto cross = [](double ux, double uy, double vx, double vy) { return ux * vy - uy * vx; };
-        double abx = bx - ax, aby = by - ay;
-        double acx = cx - ax, acy = cy - ay;
-        double adx = dx - ax, ady = dy - ay;
-        double cdx = dx - cx, cdy = dy - cy;
-        double cax = ax - cx, cay = ay - cy;
-
-        double d1 = cross(abx, aby, acx, acy);
-        double d2 = cross(abx, aby, adx, ady);
-        double d3 = cross(cdx, cdy, cax, cay);
-        double d4 = cross(cdx, cdy, bx - cx, by - cy);
-
-        if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) &&
-            ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
-            return true;
-        return false;
-    };
-
-    double left = rx, right = rx + rw, top = ry, bottom = ry + rh;
-    if (seg_intersect(x1, y1, x2, y2, left, top, left, bottom)) return true;
-    if (seg_intersect(x1, y1, x2, y2, right, top, right, bottom)) return true;
-    if (seg_intersect(x1, y1, x2, y2, left, top, right, top)) return true;
-    if (seg_intersect(x1, y1, x2, y2, left, bottom, right, bottom)) return true;
-    return false;
-}
-
-void HilichurlMelee::load_assets()
+namespace
 {
-    load_bitmap("h_melee_idle", "../image/enemy/hilichurl/melee_idle.png");
-    load_bitmap("h_melee_a0", "../image/enemy/hilichurl/melee_attack_0.png");
-    load_bitmap("h_melee_a1", "../image/enemy/hilichurl/melee_attack_1.png");
-    load_bitmap("h_melee_a2", "../image/enemy/hilichurl/melee_attack_2.png");
-
-    idle_ = bitmap_named("h_melee_idle");
-    attack_frames_[0] = bitmap_named("h_melee_a0");
-    attack_frames_[1] = bitmap_named("h_melee_a1");
-    attack_frames_[2] = bitmap_named("h_melee_a2");
-
-    width = bitmap_width(idle_);
-    height = bitmap_height(idle_);
-    hp = 120;
+    // Attack frames 0-2 (poses 1-3), 6 frames each; the attack ends with it
+    const AnimClip swing_clip = AnimClip::uniform(3, 6, false, 1);
 }
 
-void HilichurlMelee::update(player_data &player, std::vector<Bullet> &bullets)
+void HilichurlMelee::update(GameWorld &world)
 {
+    player_data &player = world.player;
     if (!alive) return;
 
     
@@ -77,26 +28,19 @@ void HilichurlMelee::update(player_data &player, std::vector<Bullet> &bullets)
     // Move towards player when chasing
     if (state_ == CHASE)
     {
-        double dx = player.player_x - x;
-        double dy = player.player_y - y;
-        double len = sqrt(dx * dx + dy * dy);
-        if (len > 0)
-        {
-            dx /= len; dy /= len;
-            x += dx * speed_;
-            y += dy * speed_;
-        }
-
-        // If touching player, start telegraph instead of damage
-        double pdx = std::fabs(player.player_x - x);
-        double pdy = std::fabs(player.player_y - y);
-        if (pdx < (player.player_width + width / 2) && pdy < (player.player_hight + height / 2))
+        FlowField::Step step = world.flow.sample(x, y);
+        double speed = current_speed();
+        x += step.dx * speed;
+        y += step.dy * speed;
+
+        // If the swing would reach the player, start telegraph instead of damage
+        if (place(info().frame(strike_pose_).hit)
+                .overlaps(player.player_x, player.player_y, player.player_width, player.player_hight))
         {
             state_ = TELEGRAPH;
             telegraph_timer_ = telegraph_duration_;
             // Play telegraph sound
-            load_sound_effect("attack_sfx", "../sound/attack.mp3");
-            play_sound_effect("attack_sfx", 0.6);
+            play_sfx(world, "attack_sfx", "../sound/attack.mp3", 0.6);
         }
     }
     else if (state_ == TELEGRAPH)
@@ -108,27 +52,21 @@ void HilichurlMelee::update(player_data &player, std::vector<Bullet> &bullets)
             // Backstep and mark as blocked to avoid damage later
             double back = 10.0;
             if (player.facing == FACING_LEFT) player.player_x += back; else player.player_x -= back;
-            load_sound_effect("block_sfx", "../sound/block.mp3");
-            play_sound_effect("block_sfx", 0.7);
+            play_sfx(world, "block_sfx", "../sound/block.mp3", 0.7);
             was_blocked_ = true;
             dealt_damage_ = true;
         }
         if (telegraph_timer_ <= 0)
         {
             state_ = ATTACK;
-            atk_frame_ = 0; atk_timer_ = 0; dealt_damage_ = false;
+            atk_ = {}; dealt_damage_ = false;
             // If already blocked during telegraph, keep the blocked flag (dealt_damage_ will be reset above; restore)
             if (was_blocked_) dealt_damage_ = true;
         }
     }
     else if (state_ == ATTACK)
     {
-        atk_timer_++;
-        if (atk_timer_ >= atk_interval_)
-        {
-            atk_timer_ = 0;
-            atk_frame_++;
-        }
+        swing_clip.step(atk_);
 
         // If player is blocking at any point during the attack window, count as successful block (lenient)
         if (!dealt_damage_ && player.blocking)
@@ -137,18 +75,15 @@ void HilichurlMelee::update(player_data &player, std::vector<Bullet> &bullets)
             double back = 10.0;
             if (player.facing == FACING_LEFT) player.player_x += back; else player.player_x -= back;
             // Play block sound
-            load_sound_effect("block_sfx", "../sound/block.mp3");
-            play_sound_effect("block_sfx", 0.7);
+            play_sfx(world, "block_sfx", "../sound/block.mp3", 0.7);
             dealt_damage_ = true; // consume this attack
             was_blocked_ = true;
         }
 
-        // Deal damage around the 2nd frame (core hit frame)
-        if (atk_frame_ == 1 && !dealt_damage_)
+        // Deal damage on the frames with a hitbox (the 2nd, core hit frame)
+        if (!dealt_damage_)
         {
-            double dx = std::fabs(player.player_x - x);
-            double dy = std::fabs(player.player_y - y);
-            if (dx < (player.player_width + width / 2) && dy < (player.player_hight + height / 2))
+            if (strikes(player.player_x, player.player_y, player.player_width, player.player_hight))
             {
                 if (!(player.blocking))
                 {
@@ -178,8 +113,7 @@ void HilichurlMelee::update(player_data &player, std::vector<Bullet> &bullets)
                     // Blocking during the hit frame: successful block backstep
                     double back = 10.0;
                     if (player.facing == FACING_LEFT) player.player_x += back; else player.player_x -= back;
-                    load_sound_effect("block_sfx", "../sound/block.mp3");
-                    play_sound_effect("block_sfx", 0.7);
+                    play_sfx(world, "block_sfx", "../sound/block.mp3", 0.7);
                     was_blocked_ = true;
                 }
                 // prevent duplicate processing
@@ -187,7 +121,7 @@ void HilichurlMelee::update(player_data &player, std::vector<Bullet> &bullets)
             }
         }
 
-        if (atk_frame_ >= 3)
+        if (swing_clip.done(atk_))
         {
             state_ = RECOVER;
             recover_timer_ = was_blocked_ ? blocked_recover_duration_ : recover_duration_;
@@ -202,91 +136,72 @@ void HilichurlMelee::update(player_data &player, std::vector<Bullet> &bullets)
             state_ = CHASE;
         }
     }
-
-    // Bullet collisions (use full sprite rect + segment test)
-    for (auto &b : bullets)
-    {
-        if (!b.active) continue;
-        double rx = x, ry = y, rw = width, rh = height;
-        double prev_x = b.x - b.dx;
-        double prev_y = b.y - b.dy;
-        bool hit = h_point_in_rect(b.x, b.y, rx, ry, rw, rh) ||
-                   h_segment_intersects_rect(prev_x, prev_y, b.x, b.y, rx, ry, rw, rh);
-        if (hit)
-        {
-            hp -= b.damage;
-            if (!b.piercing) b.active = false;
-            
-            if (hp <= 0)
-            {
-                alive = false;
-                extern int kill_marker_timer; kill_marker_timer = 12;
-                // spawn coins
-                extern std::vector<Coin> coins;
-                Coin c; c.x = x + width / 2; c.y = y + height / 2; c.value = 3 + rand() % 3; c.active = true;
-                load_bitmap("coin_1", "../image/ui/coin1.png");
-                load_bitmap("coin_2", "../image/ui/coin2.png");
-                load_bitmap("coin_3", "../image/ui/coin3.png");
-                load_bitmap("coin_4", "../image/ui/coin4.png");
-                load_bitmap("coin_5", "../image/ui/coin5.png");
-                load_bitmap("coin_6", "../image/ui/coin6.png");
-                load_bitmap("coin_7", "../image/ui/coin7.png");
-                load_bitmap("coin_8", "../image/ui/coin8.png");
-                load_bitmap("coin_9", "../image/ui/coin9.png");
-                load_bitmap("coin_10", "../image/ui/coin10.png");
-                c.frames = { bitmap_named("coin_1"), bitmap_named("coin_2"), bitmap_named("coin_3"), bitmap_named("coin_4"), bitmap_named("coin_5"), bitmap_named("coin_6"), bitmap_named("coin_7"), bitmap_named("coin_8"), bitmap_named("coin_9"), bitmap_named("coin_10") };
-                c.frame = 0; c.frame_timer = 0; c.frame_interval = 20; c.frame_count = 10;
-                coins.push_back(c);
-            }
-        }
-    }
-
-    // Cooldown decrement (follow existing pattern)
-    if (player.damage_cooldown > 0) player.damage_cooldown--;
 }
 
-void HilichurlMelee::draw() const
+int HilichurlMelee::pose() const
 {
-    if (!alive) return;
+    if (state_ != ATTACK)
+        return 0; // idle
+    return swing_clip.frame(atk_);
+}
 
-    bitmap frame = idle_;
-    if (state_ == ATTACK)
+bool HilichurlMelee::take_hit(GameWorld &world, int damage)
+{
+    hp -= damage;
+    slow_timer = info().slow_time;
+    if (hp <= 0)
     {
-        int idx = atk_frame_;
-        if (idx < 0) idx = 0; if (idx > 2) idx = 2;
-        frame = attack_frames_[idx];
+        alive = false;
+        world.kill_marker_timer = 12;
+        // spawn coins
+        spawn_coin(world, x + width / 2, y + height / 2, info().coin_min + world.rng.below(info().coin_rand));
     }
+    return true;
+}
 
-    if (facing_left_)
-    {
-        drawing_options opts = option_flip_y();
-        draw_bitmap(frame, x, y, opts);
-    }
-    else
-    {
-        draw_bitmap(frame, x, y);
-    }
+void HilichurlMelee::capture(const ViewRect &view, WorldLayer &out) const
+{
+    if (!alive || !view.sees(x, y - 10, width, height + 10)) return;
 
-    // Hit white flash overlay
-    
+    out.enemies.push_back({x, y, width, height, info().sprite(pose()), facing_left_,
+                           static_cast<double>(hp) / max_hp(), COLOR_TRANSPARENT});
 
-    // Telegraph visual: long yellow cross to screen edges
+    // Telegraph visual: long yellow cross to the view edges
     if (state_ == TELEGRAPH)
     {
         double cx = x + width / 2;
         double cy = y + height / 2;
         color tele = COLOR_YELLOW;
-        // Horizontal line across screen
-        draw_line(tele, 0, cy, screen_width(), cy);
-        draw_line(tele, 0, cy+1, screen_width(), cy+1); // slight thickness
-        // Vertical line across screen
-        draw_line(tele, cx, 0, cx, screen_height());
-        draw_line(tele, cx+1, 0, cx+1, screen_height());
+        // Horizontal line across the view
+        out.lines.push_back({tele, view.x, cy, view.x + view.w, cy});
+        out.lines.push_back({tele, view.x, cy+1, view.x + view.w, cy+1}); // slight thickness
+        // Vertical line across the view
+        out.lines.push_back({tele, cx, view.y, cx, view.y + view.h});
+        out.lines.push_back({tele, cx+1, view.y, cx+1, view.y + view.h});
     }
+}
 
-    // HP bar
-    double bar_width = width;
-    double hp_ratio = static_cast<double>(hp) / 120.0;
-    fill_rectangle(COLOR_GREEN, x, y - 10, bar_width * hp_ratio, 5);
-    draw_rectangle(COLOR_BLACK, x, y - 10, bar_width, 5);
+template <class Stream, class Self>
+void HilichurlMelee::transfer(Stream &s, Self &self)
+{
+    s.field(self.state_);
+    s.field(self.facing_left_);
+    s.field(self.telegraph_timer_);
+    s.field(self.atk_);
+    s.field(self.dealt_damage_);
+    s.field(self.was_blocked_);
+    s.field(self.recover_timer_);
+}
+
+void HilichurlMelee::save_state(ByteWriter &w) const
+{
+    EnemyBase::save_state(w);
+    transfer(w, *this);
+}
+
+void HilichurlMelee::load_state(ByteReader &r)
+{
+    EnemyBase::load_state(r);
+    transfer(r, *this);
+    swing_clip.clamp(atk_);
 }
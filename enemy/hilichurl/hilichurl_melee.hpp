@@ -9,11 +9,16 @@
 class HilichurlMelee : public EnemyBase
 {
 public:
-    HilichurlMelee() {}
+    explicit HilichurlMelee(int wave = 1) : EnemyBase(EnemyKind::HilichurlMelee, wave) {}
 
-    void load_assets() override;
-    void update(player_data &player, std::vector<Bullet> &bullets) override;
-    void draw() const override;
+    void update(GameWorld &world) override;
+    bool take_hit(GameWorld &world, int damage) override;
+    void capture(const ViewRect &view, WorldLayer &out) const override;
+    bool telegraphing() const override { return state_ == TELEGRAPH; }
+    int pose() const override;
+    bool mirrored() const override { return facing_left_; }
+    void save_state(ByteWriter &w) const override;
+    void load_state(ByteReader &r) override;
 
 private:
     enum State
@@ -24,27 +29,25 @@ private:
         RECOVER
     } state_ = CHASE;
 
-    // Visuals
-    bitmap idle_{nullptr};
-    bitmap attack_frames_[3]{};
+    // Visuals (sprites: idle, then attack frames 0-2)
     bool facing_left_ = false;
 
-    // Movement & sizing
-    double speed_ = 0.7;
-
     // Telegraph
     int telegraph_timer_ = 0;
-    const int telegraph_duration_ = 30; // yellow flash duration (extended)
+    static const int telegraph_duration_ = 30; // yellow flash duration (extended)
 
-    // Attack anim
-    int atk_frame_ = 0;
-    int atk_timer_ = 0;
-    const int atk_interval_ = 6; // frames per attack frame
+    // Attack anim (the swing clip is shared, see hilichurl_melee.cpp)
+    AnimPlayhead atk_;
+    static const int strike_pose_ = 2;  // attack frame 1: its hitbox is the swing's reach
     bool dealt_damage_ = false;  // ensure single hit
     bool was_blocked_ = false;   // track if last attack was blocked
 
     // Recover
     int recover_timer_ = 0;
-    const int recover_duration_ = 180;           // normal recover also slowed
-    const int blocked_recover_duration_ = 180;   // ~1.5s at 120 FPS
+    static const int recover_duration_ = 180;           // normal recover also slowed
+    static const int blocked_recover_duration_ = 180;   // ~1.5s at 120 FPS
+
+    // Fields shared by save_state/load_state (Stream is ByteWriter or ByteReader)
+    template <class Stream, class Self>
+    static void transfer(Stream &s, Self &self);
 };
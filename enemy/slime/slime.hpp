@@ -5,43 +5,21 @@
 class SlimeEnemy : public EnemyBase
 {
 public:
-    // Default constructor: fallback
-    SlimeEnemy()
-    {
-        width = 64;  // Slime width
-        height = 36; // Slime height
-        hp = 100;    // Health points
-        speed = 0.6; // Movement speed
-    }
+    explicit SlimeEnemy(int wave = 1) : EnemyBase(EnemyKind::Slime, wave) {}
 
-    // Constructor with wave parameter: used by spawn_enemies generator
-    SlimeEnemy(int wave)
-    {
-        width = 64;  // Slime width
-        height = 36; // Slime height
-        hp = 100;    // Health points
-        speed = 0.5; // Movement speed
-    }
-
-    void load_assets() override;                                             // Override to load assets
-    void update(player_data &player, std::vector<Bullet> &bullets) override; // Override to update state (player, bullets)
-    void draw() const override;                                              // Override to draw slime
+    void on_spawn(GameWorld &world) override;                                // Random colour
+    void update(GameWorld &world) override;                                  // Override to update state (movement, contact)
+    bool take_hit(GameWorld &world, int damage) override;                 // Apply one player hit
+    void capture(const ViewRect &view, WorldLayer &out) const override;      // Body and health bar
+    int pose() const override;                                               // Per colour: right frames, then left
+    void save_state(ByteWriter &w) const override;
+    void load_state(ByteReader &r) override;
     bool facing_left = false;                                                // Facing direction (false = right)
 
-    // Right-facing frames (2 frames)
-    bitmap right_frames[2];
-    // Left-facing frames (2 frames)
-    bitmap left_frames[2];
-
 private:
-    bitmap frames[2];         // General frame storage
-    int frame_count{2};       // Total frame count
-    int current_frame{0};     // Current active frame index
-    int frame_timer{0};       // Timer for frame switching
-    int frame_interval{20};   // Frames between frame updates
-    int slow_timer = 0;       // Remaining frames of slow effect after hit
-    double slow_factor = 0.5; // Speed reduction ratio (e.g., 0.5 = 50%)
+    uint8_t colour{0};        // Sprite set, picked at random (see enemies.def)
+    AnimPlayhead anim;        // Bounce clip (shared, see slime.cpp)
 
-protected:
-    double speed{0.5}; // Base movement speed
+    template <class Stream, class Self>
+    static void transfer(Stream &s, Self &self); // Snapshot fields (shared by save/load)
 };
\ No newline at end of file
@@ -0,0 +1,222 @@
+// Sprite collision masks: masks.def parser and the row queries.
+#include "sprite_mask.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    // One pose's mask as stored and mirrored
+    struct PoseMask
+    {
+        bool used = false;
+        SpriteMask mask, mirror;
+    };
+
+    struct Masks
+    {
+        std::vector<std::vector<PoseMask>> poses; // [kind][pose]
+        std::string error;
+    };
+
+    bool fail(Masks &masks, int line, const std::string &msg)
+    {
+        masks.error = std::string(kMaskDefsPath) + ":" + std::to_string(line) + ": " + msg;
+        masks.poses.assign(kEnemyKinds, {});
+        return false;
+    }
+
+    bool load(Masks &masks, const char *path)
+    {
+        masks.poses.assign(kEnemyKinds, {});
+        std::ifstream file(path);
+        if (!file.is_open())
+            return fail(masks, 0, "cannot open");
+
+        PoseMask *cur = nullptr; // Mask whose rows are being read
+        int next_row = 0;
+        std::string raw;
+        int line = 1;
+        for (; std::getline(file, raw); ++line)
+        {
+            std::istringstream in(raw.substr(0, raw.find('#')));
+            std::string key;
+            if (!(in >> key))
+                continue;
+
+            if (cur && next_row < cur->mask.height())
+            {
+                // One row: words() hex words, the first holding pixels 0-63
+                uint64_t *row = cur->mask.row(next_row++);
+                for (int k = 0; k < cur->mask.words(); ++k)
+                {
+                    std::string word = k == 0 ? key : "";
+                    if (k > 0 && !(in >> word))
+                        return fail(masks, line, "row needs " + std::to_string(cur->mask.words()) + " words");
+                    size_t used = 0;
+                    try { row[k] = std::stoull(word, &used, 16); } catch (...) { used = 0; }
+                    if (used == 0 || used != word.size())
+                        return fail(masks, line, "bad row word '" + word + "'");
+                }
+                if (next_row == cur->mask.height())
+                    cur->mirror = cur->mask.mirrored();
+                continue;
+            }
+
+            std::string name, full;
+            EnemyKind kind;
+            int pose = -1, w = 0, h = 0;
+            if (key != "mask" || !(in >> name >> pose >> w >> h) || !find_enemy_kind(name, kind))
+                return fail(masks, line, "expected 'mask <enemy> <pose> <w> <h> [full]'");
+            const int poses = (int)enemy_archetype(kind).frames.size();
+            if (pose < 0 || pose >= poses || w < 1 || h < 1 || w > 4096 || h > 4096)
+                return fail(masks, line, name + " has poses 0-" + std::to_string(poses - 1) + " and masks need a size");
+            auto &list = masks.poses[(int)kind];
+            if ((int)list.size() < poses)
+                list.resize(poses);
+            if (list[pose].used)
+                return fail(masks, line, "duplicate mask for " + name + " pose " + std::to_string(pose));
+            if (in >> full)
+            {
+                // Opaque everywhere: the boxes are exact, no mask needed
+                if (full != "full")
+                    return fail(masks, line, "bad line '" + full + "'");
+                cur = nullptr;
+                continue;
+            }
+            cur = &list[pose];
+            cur->used = true;
+            cur->mask = SpriteMask(w, h);
+            next_row = 0;
+        }
+        if (cur && next_row < cur->mask.height())
+            return fail(masks, line, "mask rows missing");
+        return true;
+    }
+
+    // Parsed on first use (thread-safe), never reloaded
+    const Masks &masks()
+    {
+        static const Masks m = [] {
+            Masks r;
+            load(r, kMaskDefsPath);
+            return r;
+        }();
+        return m;
+    }
+}
+
+SpriteMask::SpriteMask(int w, int h)
+    : w_(w), h_(h), words_((w + 63) / 64), bits_((size_t)words_ * h, 0)
+{
+}
+
+bool SpriteMask::any_in(int x0, int y0, int x1, int y1) const
+{
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, w_);
+    y1 = std::min(y1, h_);
+    for (int y = y0; y < y1 && x0 < x1; ++y)
+        if (first_in_row(y, x0, x1 - 1, false) >= 0)
+            return true;
+    return false;
+}
+
+int SpriteMask::first_in_row(int y, int c0, int c1, bool from_right) const
+{
+    const uint64_t *r = row(y);
+    const int w0 = c0 / 64, w1 = c1 / 64;
+    const uint64_t first = ~uint64_t(0) << (c0 % 64);
+    const uint64_t last = ~uint64_t(0) >> (63 - c1 % 64);
+    for (int i = 0; i <= w1 - w0; ++i)
+    {
+        const int w = from_right ? w1 - i : w0 + i;
+        uint64_t bits = r[w];
+        if (w == w0) bits &= first;
+        if (w == w1) bits &= last;
+        if (bits)
+            return w * 64 + (from_right ? 63 - __builtin_clzll(bits) : __builtin_ctzll(bits));
+    }
+    return -1;
+}
+
+bool SpriteMask::raycast(double x, double y, double ux, double uy, double t0, double t1, double &t) const
+{
+    // Clip [t0, t1] to the mask's bounds
+    const double p[2] = {x, y}, u[2] = {ux, uy}, hi[2] = {(double)w_, (double)h_};
+    for (int a = 0; a < 2; ++a)
+    {
+        if (u[a] == 0)
+        {
+            if (p[a] < 0 || p[a] >= hi[a])
+                return false;
+            continue;
+        }
+        double ta = -p[a] / u[a], tb = (hi[a] - p[a]) / u[a];
+        if (ta > tb) std::swap(ta, tb);
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+    }
+    if (t0 > t1)
+        return false;
+
+    // Rows in the order the ray crosses them; in each, the columns it spans
+    // are tested against the row a word at a time
+    auto row_at = [&](double v) { return std::clamp((int)std::floor(v), 0, h_ - 1); };
+    auto col_at = [&](double v) { return std::clamp((int)std::floor(v), 0, w_ - 1); };
+    const int r0 = row_at(y + uy * t0), r1 = row_at(y + uy * t1);
+    const int step = r1 >= r0 ? 1 : -1;
+    for (int r = r0;; r += step)
+    {
+        double ta = t0, tb = t1;
+        if (uy != 0)
+        {
+            double ea = (r - y) / uy, eb = (r + 1 - y) / uy;
+            if (ea > eb) std::swap(ea, eb);
+            ta = std::max(ta, ea);
+            tb = std::min(tb, eb);
+        }
+        if (ta <= tb)
+        {
+            double xa = x + ux * ta, xb = x + ux * tb;
+            int c = first_in_row(r, col_at(std::min(xa, xb)), col_at(std::max(xa, xb)), ux < 0);
+            if (c >= 0)
+            {
+                // Into the row or into the pixel's column, whichever is later
+                double tc = ux > 0 ? (c - x) / ux : ux < 0 ? (c + 1 - x) / ux : ta;
+                t = std::max(ta, tc);
+                return true;
+            }
+        }
+        if (r == r1)
+            return false;
+    }
+}
+
+SpriteMask SpriteMask::mirrored() const
+{
+    SpriteMask m(w_, h_);
+    for (int y = 0; y < h_; ++y)
+        for (int x = 0; x < w_; ++x)
+            if ((row(y)[x / 64] >> (x % 64)) & 1)
+            {
+                const int mx = w_ - 1 - x;
+                m.row(y)[mx / 64] |= uint64_t(1) << (mx % 64);
+            }
+    return m;
+}
+
+const SpriteMask *enemy_mask(EnemyKind kind, int pose, bool mirrored)
+{
+    const auto &list = masks().poses[(int)kind];
+    if (pose < 0 || pose >= (int)list.size() || !list[pose].used)
+        return nullptr;
+    return mirrored ? &list[pose].mirror : &list[pose].mask;
+}
+
+const std::string &mask_defs_error()
+{
+    return masks().error;
+}
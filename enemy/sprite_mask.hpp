@@ -0,0 +1,59 @@
+// Sprite collision masks: one bit per pixel (opaque or not) for every pose of
+// every archetype, generated from the PNGs by tools/build_masks and read once
+// from enemy/masks.def. Rows are packed 64 pixels to a word, so the narrow
+// phase after a box hit ANDs a few words per row: a contact is one masked
+// word per row of the overlap, a ray one or two words per row it crosses.
+//
+// Masks belong to the poses of enemies.def (the sprites of the first set),
+// like the frame boxes, and are placed at the enemy's position. A pose with
+// no mask, or a fully opaque one, is collided by its boxes alone.
+#pragma once
+#include "enemy_archetype.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const char *const kMaskDefsPath = "enemy/masks.def";
+
+class SpriteMask
+{
+public:
+    SpriteMask() = default;
+    SpriteMask(int w, int h);
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+    int words() const { return words_; } // 64-bit words per row
+
+    // Row y, words() words; bit i of word k is pixel 64k + i
+    uint64_t *row(int y) { return &bits_[(size_t)y * words_]; }
+    const uint64_t *row(int y) const { return &bits_[(size_t)y * words_]; }
+
+    // Whether any opaque pixel lies in columns x0..x1-1 of rows y0..y1-1
+    // (clipped to the mask)
+    bool any_in(int x0, int y0, int x1, int y1) const;
+
+    // Whether the ray from (x, y) along the unit vector (ux, uy), in mask
+    // pixels, crosses an opaque pixel between t0 and t1; on a hit `t` is
+    // where it enters the first one (to the pixel)
+    bool raycast(double x, double y, double ux, double uy, double t0, double t1, double &t) const;
+
+    // This mask mirrored left to right
+    SpriteMask mirrored() const;
+
+private:
+    int w_ = 0, h_ = 0;
+    int words_ = 0;
+    std::vector<uint64_t> bits_;
+
+    // First opaque pixel in columns c0..c1 of row y, from the left (or the
+    // right when `from_right`); -1 if none
+    int first_in_row(int y, int c0, int c1, bool from_right) const;
+};
+
+// Mask of pose `pose` of `kind`, drawn mirrored or not; nullptr when the pose
+// is collided by its boxes alone
+const SpriteMask *enemy_mask(EnemyKind kind, int pose, bool mirrored);
+
+// Empty when masks.def loaded, else "file:line: message"
+const std::string &mask_defs_error();
@@ -0,0 +1,236 @@
+// Wave schedule: waves.def parser and timeline compiler
+#include "wave_schedule.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    struct Schedule
+    {
+        std::vector<WaveInfo> waves; // waves[0] is wave 1
+        EndlessInfo endless;
+        bool has_endless = false;
+        std::string error;
+    };
+
+    bool fail(Schedule &sched, int line, const std::string &msg)
+    {
+        sched.error = std::string(kWaveDefsPath) + ":" + std::to_string(line) + ": " + msg;
+        sched.waves.clear();
+        return false;
+    }
+
+    bool parse_edge(const std::string &name, SpawnEdge &out)
+    {
+        if (name == "top") out = SpawnEdge::Top;
+        else if (name == "right") out = SpawnEdge::Right;
+        else if (name == "bottom") out = SpawnEdge::Bottom;
+        else if (name == "left") out = SpawnEdge::Left;
+        else if (name == "any") out = SpawnEdge::Any;
+        else if (name == "top_centre") out = SpawnEdge::TopCentre;
+        else return false;
+        return true;
+    }
+
+    // Apply one "key values..." line to `w`; `interval` is the wait given to
+    // the events that follow. False on an unknown key or bad value.
+    bool parse_key(WaveInfo &w, int &interval, const std::string &key, std::istringstream &in)
+    {
+        if (key == "max_alive") in >> w.max_alive;
+        else if (key == "interval")
+        {
+            in >> interval;
+            return !in.fail() && interval >= 0;
+        }
+        else if (key == "mix")
+        {
+            w.mix_count = 0;
+            std::string name;
+            int weight = 0, sum = 0;
+            while (in >> name >> weight)
+            {
+                if (w.mix_count == kMaxMixKinds || weight <= 0 || !find_enemy_kind(name, w.mix_kind[w.mix_count]))
+                    return false;
+                sum += weight;
+                w.mix_upto[w.mix_count++] = sum;
+            }
+            return w.mix_count > 0 && in.eof();
+        }
+        else if (key == "spawn")
+        {
+            // Unrolled here, so the runtime never has to count repeats
+            int times = 0;
+            std::string kind, edge;
+            SpawnEvent ev;
+            ev.wait = interval;
+            if (!(in >> times >> kind >> edge) || times < 1 || !parse_edge(edge, ev.edge))
+                return false;
+            if (!(in >> ev.count))
+                ev.count = 1;
+            ev.mixed = kind == "mix";
+            if (ev.count < 1 || (!ev.mixed && !find_enemy_kind(kind, ev.kind)))
+                return false;
+            w.timeline.insert(w.timeline.end(), times, ev);
+            w.total += times * ev.count;
+            w.boss = w.boss || (!ev.mixed && ev.kind == EnemyKind::Boss);
+            return true;
+        }
+        else return false;
+        return !in.fail();
+    }
+
+    // Keys of the endless block; `mix` and `interval` are shared with waves
+    bool parse_endless_key(EndlessInfo &e, const std::string &key, std::istringstream &in)
+    {
+        if (key == "enemies") in >> e.enemies >> e.enemies_growth;
+        else if (key == "max_alive") in >> e.alive >> e.alive_growth >> e.alive_cap;
+        else if (key == "group") in >> e.group >> e.group_growth >> e.group_cap;
+        else return key != "spawn" && parse_key(e.base, e.interval, key, in);
+        return !in.fail() && e.enemies >= 1 && e.alive >= 1 && e.group >= 1;
+    }
+
+    bool load(Schedule &sched, const char *path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+            return fail(sched, 0, "cannot open");
+
+        WaveInfo cur;
+        int interval = 60;
+        bool in_block = false, in_endless = false;
+        std::string raw;
+        for (int line = 1; std::getline(file, raw); ++line)
+        {
+            std::istringstream in(raw.substr(0, raw.find('#')));
+            std::string key;
+            if (!(in >> key))
+                continue;
+
+            if (key == "wave")
+            {
+                int n = 0;
+                if (in_block || !(in >> n) || n != (int)sched.waves.size() + 1)
+                    return fail(sched, line, "expected 'wave " + std::to_string(sched.waves.size() + 1) +
+                                                 "' outside a block");
+                cur = WaveInfo();
+                interval = 60;
+                in_block = true;
+            }
+            else if (key == "endless")
+            {
+                if (in_block || sched.has_endless)
+                    return fail(sched, line, "one 'endless' block, outside a wave");
+                in_block = in_endless = sched.has_endless = true;
+            }
+            else if (key == "end" && in_endless)
+            {
+                if (sched.endless.base.mix_count == 0)
+                    return fail(sched, line, "'endless' needs a 'mix' line");
+                in_block = in_endless = false;
+            }
+            else if (in_endless)
+            {
+                if (!parse_endless_key(sched.endless, key, in))
+                    return fail(sched, line, "bad line '" + key + "'");
+            }
+            else if (key == "end")
+            {
+                if (!in_block)
+                    return fail(sched, line, "'end' without 'wave'");
+                if (cur.timeline.empty() || cur.max_alive < 1)
+                    return fail(sched, line, "wave needs a spawn line and positive max_alive");
+                for (const SpawnEvent &ev : cur.timeline)
+                    if (ev.mixed && cur.mix_count == 0)
+                        return fail(sched, line, "'spawn ... mix' without a 'mix' line");
+                sched.waves.push_back(cur);
+                in_block = false;
+            }
+            else if (!in_block || !parse_key(cur, interval, key, in))
+            {
+                return fail(sched, line, "bad line '" + key + "'");
+            }
+        }
+        if (in_block)
+            return fail(sched, 0, "missing 'end'");
+        if (sched.waves.empty())
+            return fail(sched, 0, "no waves defined");
+        if (!sched.has_endless)
+            return fail(sched, 0, "no 'endless' block");
+        return true;
+    }
+
+    // Parsed on first use (thread-safe), never reloaded
+    const Schedule &schedule()
+    {
+        static const Schedule sched = [] {
+            Schedule s;
+            load(s, kWaveDefsPath);
+            return s;
+        }();
+        return sched;
+    }
+}
+
+const WaveInfo *wave_info(int wave)
+{
+    const Schedule &sched = schedule();
+    if (wave < 1 || wave > (int)sched.waves.size())
+        return nullptr;
+    return &sched.waves[wave - 1];
+}
+
+void build_endless_wave(int wave, WaveInfo &out)
+{
+    const EndlessInfo &e = schedule().endless;
+    auto grow = [&](double first, double growth, double cap) {
+        return (int)std::min(cap, std::round(first * std::pow(growth, wave - 1)));
+    };
+    const int enemies = grow(e.enemies, e.enemies_growth, 1e9);
+    const int group = std::max(1, grow(e.group, e.group_growth, e.group_cap));
+
+    out = e.base;
+    out.max_alive = std::max(1, grow(e.alive, e.alive_growth, e.alive_cap));
+    out.timeline.clear();
+    SpawnEvent ev;
+    ev.wait = e.interval;
+    ev.mixed = true;
+    ev.edge = SpawnEdge::Any;
+    for (int left = enemies; left > 0; left -= ev.count)
+    {
+        ev.count = std::min(group, left);
+        out.timeline.push_back(ev);
+    }
+    out.total = enemies;
+    out.boss = false;
+}
+
+int wave_count()
+{
+    return (int)schedule().waves.size();
+}
+
+bool is_final_wave(int wave)
+{
+    return wave == wave_count();
+}
+
+bool wave_has_boss(int wave)
+{
+    const WaveInfo *info = wave_info(wave);
+    return info && info->boss;
+}
+
+int next_boss_wave(int wave)
+{
+    for (int w = wave < 1 ? 1 : wave; w <= wave_count(); ++w)
+        if (wave_has_boss(w))
+            return w;
+    return 0;
+}
+
+const std::string &wave_defs_error()
+{
+    return schedule().error;
+}
@@ -0,0 +1,85 @@
+// Wave schedule: the waves of a run, read once from enemy/waves.def and
+// compiled into one spawn timeline per wave. spawn_enemies only advances a
+// cursor through the timeline; the file decides how many enemies come, when,
+// of which archetype and from which edge, leaving to chance only what it asks
+// for (a weighted archetype mix, a random edge).
+#pragma once
+#include "enemy_archetype.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const char *const kWaveDefsPath = "enemy/waves.def";
+const int kMaxMixKinds = 4;
+
+// Where a spawn event places its enemies (the first four match rng.below(4))
+enum class SpawnEdge : uint8_t
+{
+    Top,
+    Right,
+    Bottom,
+    Left,
+    Any,      // One of the four, drawn per enemy
+    TopCentre // Centred above the top edge (the boss entrance)
+};
+
+// One timeline entry: after `wait` frames, `count` enemies appear together
+struct SpawnEvent
+{
+    int wait = 60;                     // Frames since the previous attempt
+    bool mixed = false;                // Archetype drawn from the wave's mix
+    EnemyKind kind = EnemyKind::Slime; // Archetype when not mixed
+    SpawnEdge edge = SpawnEdge::Any;
+    int count = 1;
+};
+
+// One compiled wave (see waves.def for the meaning of each key)
+struct WaveInfo
+{
+    int max_alive = 10;               // An attempt with this many alive waits another `wait`
+    EnemyKind mix_kind[kMaxMixKinds]; // Weighted archetype table for mixed events,
+    int mix_upto[kMaxMixKinds];       // as cumulative weights
+    int mix_count = 0;
+    std::vector<SpawnEvent> timeline;
+    int total = 0;     // Enemies the whole timeline spawns
+    bool boss = false; // Some event spawns a boss
+
+    // Archetype for a mixed event given a roll in [0, mix_upto[mix_count - 1])
+    EnemyKind pick(int roll) const
+    {
+        int i = 0;
+        while (i < mix_count - 1 && roll >= mix_upto[i])
+            ++i;
+        return mix_kind[i];
+    }
+};
+
+// Endless mode: every wave is generated from one template whose sizes grow
+// geometrically, value(n) = first * growth^(n - 1), capped
+struct EndlessInfo
+{
+    WaveInfo base;                      // Mix and spawn interval for every wave
+    int interval = 60;
+    double enemies = 60, enemies_growth = 1.0;
+    double alive = 60, alive_growth = 1.0;
+    int alive_cap = 1000;
+    double group = 1, group_growth = 1.0;
+    int group_cap = 64;
+};
+
+// Wave `wave` (1-based); nullptr past the last wave or if the file failed
+const WaveInfo *wave_info(int wave);
+
+// Compile endless wave `wave` into `out` (mixed events from random edges)
+void build_endless_wave(int wave, WaveInfo &out);
+
+// Number of waves in the run; clearing the last one ends it
+int wave_count();
+bool is_final_wave(int wave);
+bool wave_has_boss(int wave);
+
+// First boss wave at or after `wave` (0: none left)
+int next_boss_wave(int wave);
+
+// Empty when waves.def loaded, else "file:line: message"
+const std::string &wave_defs_error();
@@ -0,0 +1,32 @@
+// Animation clips: the per-tick frame and step tables.
+#include "anim_clip.hpp"
+#include <algorithm>
+
+AnimClip::AnimClip(std::initializer_list<Frame> frames, bool loop) : loop_(loop)
+{
+    for (const Frame &f : frames)
+        frame_.insert(frame_.end(), std::max(f.ticks, 1), (uint8_t)f.index);
+    build_tables();
+}
+
+AnimClip AnimClip::uniform(int count, int ticks, bool loop, int first)
+{
+    AnimClip clip({}, loop);
+    clip.frame_.clear();
+    for (int i = 0; i < count; ++i)
+        clip.frame_.insert(clip.frame_.end(), std::max(ticks, 1), (uint8_t)(first + i));
+    clip.build_tables();
+    return clip;
+}
+
+void AnimClip::build_tables()
+{
+    // frame_ holds one entry per tick; add the end slot (the last frame held)
+    length_ = (int)frame_.size();
+    frame_.push_back(frame_.empty() ? 0 : frame_.back());
+
+    // Tick t steps to t + 1; the last tick wraps (loop) or stays (once)
+    next_.resize(length_ + 1);
+    for (int t = 0; t <= length_; ++t)
+        next_[t] = (uint16_t)(t + 1 < length_ ? t + 1 : loop_ ? 0 : length_);
+}
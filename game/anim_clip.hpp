@@ -0,0 +1,74 @@
+// Animation clips: the timing of a sprite animation (which frame shows for how
+// many ticks, looping or played once), built once and shared by every entity
+// that plays it. An entity keeps only its playhead, a tick count into the
+// clip, and the frame is a table lookup, so a clip costs nothing per instance
+// beyond two bytes and stepping one is a single load with no branch.
+//
+// Frames are indices into the owner's sprite list (an archetype's poses, the
+// coin frames, the player sheet), not bitmaps: the simulation steps clips in
+// headless worlds too, and enemy frames also pick the collision boxes.
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+// Per-instance animation state: ticks since the clip started (for a clip
+// played once, its length when it has finished)
+struct AnimPlayhead
+{
+    uint16_t tick = 0;
+};
+
+class AnimClip
+{
+public:
+    struct Frame
+    {
+        int index; // Sprite shown
+        int ticks; // For this many ticks (at least 1)
+    };
+
+    AnimClip(std::initializer_list<Frame> frames, bool loop);
+
+    // `count` frames index first.. of `ticks` ticks each
+    static AnimClip uniform(int count, int ticks, bool loop, int first = 0);
+
+    int length() const { return length_; } // Ticks per play-through
+    bool loops() const { return loop_; }
+
+    // Frame showing `tick` ticks into the clip (past the end: the last one)
+    int frame_at(int tick) const { return frame_[slot(tick)]; }
+    int frame(AnimPlayhead head) const { return frame_[head.tick]; }
+
+    // Whether a clip played once has reached its end (never for a loop)
+    bool done(AnimPlayhead head) const { return head.tick >= length_ && !loop_; }
+
+    // Advance by one tick: a loop wraps to its start, a clip played once
+    // stays on its end
+    void step(AnimPlayhead &head) const { head.tick = next_[head.tick]; }
+
+    // Step the playhead `member` of every element of [first, last), e.g. all
+    // the coins: one clip, one tight loop
+    template <class It, class Owner>
+    void step_all(It first, It last, AnimPlayhead Owner::*member) const
+    {
+        const uint16_t *next = next_.data();
+        for (; first != last; ++first)
+        {
+            AnimPlayhead &head = (*first).*member;
+            head.tick = next[head.tick];
+        }
+    }
+
+    // Bring a playhead read from a snapshot back into the clip
+    void clamp(AnimPlayhead &head) const { head.tick = (uint16_t)slot(head.tick); }
+
+private:
+    int length_ = 0;
+    bool loop_ = true;
+    std::vector<uint8_t> frame_; // Per tick 0..length_ (the end shows the last frame)
+    std::vector<uint16_t> next_; // Tick after each tick
+
+    int slot(int tick) const { return tick < 0 ? 0 : tick > length_ ? length_ : tick; }
+    void build_tables(); // From frame_, one entry per tick
+};
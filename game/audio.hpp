@@ -0,0 +1,127 @@
+// Gameplay sound effects and music. The simulation records requests through
+// the functions below (nothing for headless worlds); SoundFeed carries them in
+// the frame snapshots to the window thread, the only one touching SplashKit's
+// audio device and its named sounds.
+#pragma once
+#include "splashkit.h"
+#include "game_world.hpp"
+#include "sound_event.hpp"
+#include <atomic>
+#include <string>
+#include <vector>
+
+inline void record_sound(GameWorld &world, SoundOp op, const std::string &name = "", const std::string &path = "",
+                         double volume = 1.0)
+{
+    if (world.headless)
+        return;
+    world.sounds.push_back({op, name, path, volume});
+}
+
+inline void play_sfx(GameWorld &world, const std::string &name, const std::string &path, double volume)
+{
+    record_sound(world, SoundOp::Play, name, path, volume);
+}
+
+// Start a sound that repeats until stop_sfx (one voice, however fast the
+// weapon fires)
+inline void start_sfx_loop(GameWorld &world, const std::string &name, const std::string &path, double volume)
+{
+    record_sound(world, SoundOp::Loop, name, path, volume);
+}
+
+// Stop every voice of a sound; safe to call when it is not playing
+inline void stop_sfx(GameWorld &world, const std::string &name)
+{
+    record_sound(world, SoundOp::Stop, name);
+}
+
+// Switch the music to `name` (looping), or stop it
+inline void start_bgm(GameWorld &world, const std::string &name, const std::string &path, double volume)
+{
+    record_sound(world, SoundOp::Music, name, path, volume);
+}
+
+inline void stop_bgm(GameWorld &world)
+{
+    record_sound(world, SoundOp::StopMusic);
+}
+
+// Carry out one request (window thread)
+inline void play_sound_event(const SoundEvent &e)
+{
+    switch (e.op)
+    {
+    case SoundOp::Play:
+        load_sound_effect(e.name, e.path);
+        play_sound_effect(e.name, e.volume);
+        break;
+    case SoundOp::Loop:
+        load_sound_effect(e.name, e.path);
+        play_sound_effect(e.name, -1, e.volume);
+        break;
+    case SoundOp::Stop:
+        if (has_sound_effect(e.name))
+            stop_sound_effect(e.name);
+        break;
+    case SoundOp::Music:
+        stop_music();
+        load_music(e.name, e.path);
+        play_music(e.name, -1);
+        set_music_volume(e.volume);
+        break;
+    case SoundOp::StopMusic:
+        stop_music();
+        break;
+    case SoundOp::PauseMusic:
+        pause_music();
+        break;
+    case SoundOp::ResumeMusic:
+        resume_music();
+        break;
+    }
+}
+
+// Requests on their way from the simulation to the window thread. Every
+// snapshot carries all requests the window has not played yet, so none is
+// lost with a snapshot the window never reads; the window skips the ones it
+// already played and acknowledges the rest.
+class SoundFeed
+{
+public:
+    // Simulation thread: stamp and queue `recorded` (emptied), then copy the
+    // requests still unplayed into `out`
+    void collect(std::vector<SoundEvent> &recorded, std::vector<SoundEvent> &out)
+    {
+        const unsigned long played = played_.load(std::memory_order_acquire);
+        size_t drop = 0;
+        while (drop < pending_.size() && pending_[drop].seq <= played)
+            drop++;
+        pending_.erase(pending_.begin(), pending_.begin() + drop);
+        for (SoundEvent &e : recorded)
+        {
+            e.seq = ++stamped_;
+            pending_.push_back(std::move(e));
+        }
+        recorded.clear();
+        out = pending_;
+    }
+
+    // Window thread: play the requests of a snapshot that are new
+    void play(const std::vector<SoundEvent> &events)
+    {
+        for (const SoundEvent &e : events)
+            if (e.seq > heard_)
+            {
+                play_sound_event(e);
+                heard_ = e.seq;
+            }
+        played_.store(heard_, std::memory_order_release);
+    }
+
+private:
+    std::vector<SoundEvent> pending_;      // Simulation side: stamped, not acknowledged
+    unsigned long stamped_ = 0;            // Simulation side: last stamp handed out
+    unsigned long heard_ = 0;              // Window side: last request played
+    std::atomic<unsigned long> played_{0}; // Window -> simulation acknowledgement
+};
@@ -0,0 +1,205 @@
+// Autopilot policy used by the batch simulator.
+#include "autopilot.hpp"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const double kInf = std::numeric_limits<double>::infinity();
+    const double keep_min = 220.0;   // Back off when an enemy is closer than this
+    const double keep_max = 420.0;   // Close in when the nearest enemy is further
+    const double block_range = 140.0; // Telegraphs closer than this get blocked
+    const double dash_range = 70.0;   // Dash away when something is this close
+    const double wall_margin = 96.0;  // Steer away from arena edges inside this band
+    const int shot_lead = 3;          // Block projectiles that land within this many frames
+    const double shot_margin = 6.0;   // on the player grown by this (it may walk into them)
+    const double beam_clear = 40.0;   // Walk away from beams closer than this past their reach
+
+    // Whether a projectile moving in a straight line enters the box
+    // (x, y, w, h) within `frames` frames
+    bool lands_within(const ProjectileInfo &p, double x, double y, double w, double h, int frames)
+    {
+        for (int t = 1; t <= frames; ++t)
+        {
+            double sx = p.x + p.dx * t, sy = p.y + p.dy * t;
+            if (sx > x && sx < x + w && sy > y && sy < y + h)
+                return true;
+        }
+        return false;
+    }
+
+    // Distance from (px, py) to the line of a beam past its start, and the
+    // unit vector from the line toward the point (the way out). The line is
+    // taken past the beam's end too: a growing beam keeps growing.
+    double beam_distance(const BeamInfo &b, double px, double py, double &out_x, double &out_y)
+    {
+        double bx = b.x1 - b.x0, by = b.y1 - b.y0;
+        double len = std::sqrt(bx * bx + by * by);
+        if (len == 0)
+            return kInf;
+        bx /= len;
+        by /= len;
+        double along = (px - b.x0) * bx + (py - b.y0) * by;
+        if (along < 0)
+            return kInf;
+        double side = (px - b.x0) * -by + (py - b.y0) * bx;
+        out_x = side >= 0 ? -by : by;
+        out_y = side >= 0 ? bx : -bx;
+        return std::fabs(side);
+    }
+}
+
+InputState autopilot_input(const GameWorld &world, AutopilotState &bot)
+{
+    InputState in;
+    const player_data &player = world.player;
+    double px = player.player_x + player.player_width / 2.0;
+    double py = player.player_y + player.player_hight / 2.0;
+
+    // Nearest live enemy, and whether any melee wind-up is within reach
+    const EnemyBase *target = nullptr;
+    double best_d2 = 0;
+    bool threat = false;
+    for (const auto &e : world.enemies)
+    {
+        if (!e->alive)
+            continue;
+        double dx = e->x + e->width / 2.0 - px;
+        double dy = e->y + e->height / 2.0 - py;
+        double d2 = dx * dx + dy * dy;
+        if (!target || d2 < best_d2)
+        {
+            target = e.get();
+            best_d2 = d2;
+        }
+        if (e->telegraphing() && d2 < block_range * block_range)
+            threat = true;
+    }
+
+    // Projectiles (arrows, boss shots) about to land
+    bot.shots.clear();
+    for (const auto &e : world.enemies)
+        e->collect_projectiles(bot.shots);
+    for (const ProjectileInfo &p : bot.shots)
+        if (lands_within(p, player.player_x - shot_margin, player.player_y - shot_margin,
+                         player.player_width + 2 * shot_margin, player.player_hight + 2 * shot_margin, shot_lead))
+            threat = true;
+
+    // Beams (the boss's lasers) sweep too slowly to be worth blocking: walk
+    // away from the nearest one close by
+    bot.beams.clear();
+    for (const auto &e : world.enemies)
+        e->collect_beams(bot.beams);
+    bool dodge = false;
+    double dodge_x = 0, dodge_y = 0, dodge_d = kInf;
+    for (const BeamInfo &b : bot.beams)
+    {
+        double ox, oy;
+        double d = beam_distance(b, px, py, ox, oy);
+        if (d < b.reach + beam_clear && d < dodge_d)
+        {
+            dodge = true;
+            dodge_x = ox;
+            dodge_y = oy;
+            dodge_d = d;
+        }
+    }
+
+    if (bot.block_cooldown > 0)
+        bot.block_cooldown--;
+    if (--bot.strafe_timer <= 0)
+    {
+        bot.strafe_dir = -bot.strafe_dir;
+        bot.strafe_timer = 90;
+    }
+
+    if (!target)
+    {
+        in.aim_x = px + 100;
+        in.aim_y = py;
+        return in;
+    }
+
+    double tx = target->x + target->width / 2.0;
+    double ty = target->y + target->height / 2.0;
+    double dist = std::sqrt(best_d2);
+
+    // Aim at the body and shoot (click every tick; weapons apply their own
+    // cooldowns)
+    const HitRect body = target->hurtbox();
+    in.aim_x = body.x + body.w / 2.0;
+    in.aim_y = body.y + body.h / 2.0;
+    in.fire_down = true;
+    in.fire_clicked = true;
+
+    if (threat && !player.blocking && bot.block_cooldown == 0)
+    {
+        in.block_pressed = true;
+        bot.block_cooldown = player_block_duration();
+        return in; // blocking roots the player anyway
+    }
+
+    // Desired direction: away / towards / around the target
+    double ux = dist > 0 ? (tx - px) / dist : 1.0;
+    double uy = dist > 0 ? (ty - py) / dist : 0.0;
+    double mx, my;
+    if (dist < keep_min)
+    {
+        mx = -ux;
+        my = -uy;
+    }
+    else if (dist > keep_max)
+    {
+        mx = ux;
+        my = uy;
+    }
+    else
+    {
+        mx = -uy * bot.strafe_dir;
+        my = ux * bot.strafe_dir;
+    }
+    if (dodge)
+    {
+        // Off the beam, then keep circling the same way so as not to cross
+        // it again straight away
+        mx = dodge_x;
+        my = dodge_y;
+        bot.strafe_dir = -uy * dodge_x + ux * dodge_y >= 0 ? 1 : -1;
+        bot.strafe_timer = 90;
+    }
+
+    // Don't get pinned against the arena edge
+    if (px < wall_margin) mx = 1;
+    if (px > world.arena_w - wall_margin) mx = -1;
+    if (py < wall_margin) my = 1;
+    if (py > world.arena_h - wall_margin) my = -1;
+
+    in.move_left = mx < -0.3;
+    in.move_right = mx > 0.3;
+    in.move_up = my < -0.3;
+    in.move_down = my > 0.3;
+
+    if (dist < dash_range && in.moving())
+        in.dash_pressed = true;
+
+    return in;
+}
+
+void autopilot_intermission(GameWorld &world, ShopState &shop)
+{
+    // Most expensive weapon we can afford goes into slot 0
+    int pick = -1;
+    for (int i = 0; i < (int)shop.items.size(); ++i)
+    {
+        const ShopItem &it = shop.items[i];
+        int price = weapon_info(it.type).price;
+        if (it.unlocked || price > world.money)
+            continue;
+        if (pick == -1 || price > weapon_info(shop.items[pick].type).price)
+            pick = i;
+    }
+    if (pick != -1 && shop_unlock(shop, pick, world.money))
+        shop_equip(shop, pick, 0, world.weapons, world.current_weapon, !world.headless);
+
+    begin_next_wave(world);
+}
@@ -0,0 +1,25 @@
+// Autopilot: a scripted player for headless runs. It produces the same
+// InputState a human would, so the simulation cannot tell the difference.
+#pragma once
+#include "game_world.hpp"
+#include "input.hpp"
+#include "../ui/shop.hpp"
+#include <vector>
+
+struct AutopilotState
+{
+    int strafe_dir = 1;    // +1 / -1: which way to circle the nearest enemy
+    int strafe_timer = 0;  // Frames until the strafe direction flips
+    int block_cooldown = 0; // Frames before another block may be started
+    std::vector<ProjectileInfo> shots; // Enemy projectiles, reused every tick
+    std::vector<BeamInfo> beams;       // and beams
+};
+
+// Decide this tick's input: aim at and shoot the nearest enemy, keep a
+// comfortable distance, block telegraphed attacks and projectiles about to
+// land, step off beams, dash out when cornered
+InputState autopilot_input(const GameWorld &world, AutopilotState &bot);
+
+// Wave-cleared intermission: buy the best affordable weapon, equip it, and
+// start the next wave
+void autopilot_intermission(GameWorld &world, ShopState &shop);
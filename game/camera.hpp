@@ -0,0 +1,36 @@
+// Camera: the screen-sized window onto the arena. The arena can be larger
+// than the screen; the view follows the player and stops at the arena edges.
+// Everything is stored in arena (world) coordinates, the view only decides
+// what gets drawn and where the simulation's active region lies.
+#pragma once
+#include <algorithm>
+
+// Axis-aligned rectangle in arena coordinates
+struct ViewRect
+{
+    double x = 0, y = 0; // Top-left corner
+    double w = 0, h = 0;
+
+    // Whether the box (bx, by, bw, bh), grown by `margin` on every side,
+    // overlaps this rectangle
+    bool sees(double bx, double by, double bw, double bh, double margin = 0) const
+    {
+        return bx + bw + margin > x && bx - margin < x + w && by + bh + margin > y && by - margin < y + h;
+    }
+
+    // Whether the point (px, py) lies within `margin` of this rectangle
+    bool sees(double px, double py, double margin) const { return sees(px, py, 0, 0, margin); }
+
+    // This rectangle grown by `margin` on every side
+    ViewRect grown(double margin) const { return {x - margin, y - margin, w + 2 * margin, h + 2 * margin}; }
+};
+
+// View of view_w x view_h centred on (cx, cy), kept inside the arena (an
+// arena smaller than the view is centred instead)
+inline ViewRect follow_camera(double cx, double cy, double view_w, double view_h, double arena_w, double arena_h)
+{
+    auto axis = [](double c, double view, double arena) {
+        return arena <= view ? (arena - view) / 2 : std::clamp(c - view / 2, 0.0, arena - view);
+    };
+    return {axis(cx, view_w, arena_w), axis(cy, view_h, arena_h), view_w, view_h};
+}
@@ -0,0 +1,83 @@
+// Crowd neighbour grid: counting-sort build and radius queries.
+#include "crowd_grid.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const double kMargin = 256; // Grid extent past the arena edges
+}
+
+int CrowdGrid::col_of(double x) const
+{
+    return std::clamp((int)std::floor((x - origin_x_) / cell_), 0, cols_ - 1);
+}
+
+int CrowdGrid::row_of(double y) const
+{
+    return std::clamp((int)std::floor((y - origin_y_) / cell_), 0, rows_ - 1);
+}
+
+void CrowdGrid::build(const std::vector<Agent> &agents, int width, int height)
+{
+    // Grid over the agents' bounding box, clipped to the arena plus a margin
+    double x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    if (!agents.empty())
+    {
+        x0 = x1 = agents[0].x;
+        y0 = y1 = agents[0].y;
+    }
+    for (const Agent &a : agents)
+    {
+        x0 = std::min(x0, a.x);
+        y0 = std::min(y0, a.y);
+        x1 = std::max(x1, a.x);
+        y1 = std::max(y1, a.y);
+    }
+    origin_x_ = std::max(x0, -kMargin);
+    origin_y_ = std::max(y0, -kMargin);
+    x1 = std::min(x1, width + kMargin);
+    y1 = std::min(y1, height + kMargin);
+    cols_ = std::max(1, (int)std::ceil((x1 - origin_x_) / cell_) + 1);
+    rows_ = std::max(1, (int)std::ceil((y1 - origin_y_) / cell_) + 1);
+    const int cells = cols_ * rows_;
+
+    // Counting pass, prefix sums, then scatter (buckets keep input order)
+    start_.assign(cells + 1, 0);
+    for (const Agent &a : agents)
+        start_[row_of(a.y) * cols_ + col_of(a.x) + 1]++;
+    for (int c = 0; c < cells; ++c)
+        start_[c + 1] += start_[c];
+
+    sorted_.resize(agents.size());
+    fill_.assign(start_.begin(), start_.end() - 1);
+    for (const Agent &a : agents)
+        sorted_[fill_[row_of(a.y) * cols_ + col_of(a.x)]++] = a;
+}
+
+void CrowdGrid::nearby(double x, double y, double radius, int max_count, std::vector<int> &out) const
+{
+    out.clear();
+    if (cols_ == 0)
+        return;
+    const double r2 = radius * radius;
+    const int c0 = col_of(x - radius), c1 = col_of(x + radius);
+    const int r0 = row_of(y - radius), r1 = row_of(y + radius), mid = row_of(y);
+    for (int i = 0; i <= 2 * (r1 - r0); ++i)
+    {
+        // mid, mid + 1, mid - 1, mid + 2, ...
+        const int r = mid + (i % 2 ? (i + 1) / 2 : -(i / 2));
+        if (r < r0 || r > r1)
+            continue;
+        // Cells c0..c1 of a row are contiguous in sorted_
+        for (int k = start_[r * cols_ + c0]; k < start_[r * cols_ + c1 + 1]; ++k)
+        {
+            double dx = sorted_[k].x - x, dy = sorted_[k].y - y;
+            if (dx * dx + dy * dy > r2)
+                continue;
+            out.push_back(k);
+            if ((int)out.size() == max_count)
+                return;
+        }
+    }
+}
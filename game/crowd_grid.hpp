@@ -0,0 +1,41 @@
+// Crowd neighbour grid: enemy centres bucketed into a uniform grid over their
+// bounding box once per tick, for crowd separation. Agents are stored flat and sorted by cell
+// (offset table plus one array, like the enemy index), and a query reads only
+// the cells around a point and stops at a fixed count, so a tick of queries
+// stays linear in the number of enemies however tightly they bunch up.
+#pragma once
+#include <vector>
+
+class CrowdGrid
+{
+public:
+    struct Agent
+    {
+        double x, y;  // Centre
+        double width; // Box width
+        int enemy;    // Index into world.enemies
+    };
+
+    // Bucket `agents` of a width x height arena (the grid stops a little
+    // past the arena; agents beyond that go into the border cells). The grid
+    // keeps its own, cell-sorted copy.
+    void build(const std::vector<Agent> &agents, int width, int height);
+
+    const std::vector<Agent> &agents() const { return sorted_; }
+
+    // Up to max_count agents whose centre lies within `radius` of (x, y),
+    // as positions in agents(). Rows are read from the one holding (x, y)
+    // outwards, so a full query keeps the closest rows. `out` is overwritten.
+    void nearby(double x, double y, double radius, int max_count, std::vector<int> &out) const;
+
+private:
+    double cell_ = 32;          // Cell size in pixels
+    int cols_ = 0, rows_ = 0;
+    double origin_x_ = 0, origin_y_ = 0; // Grid top-left, in arena coordinates
+    std::vector<Agent> sorted_; // Agents, bucket by bucket
+    std::vector<int> start_;    // Bucket c holds sorted_[start_[c] .. start_[c + 1])
+    std::vector<int> fill_;     // Build scratch: next free slot per bucket
+
+    int col_of(double x) const;
+    int row_of(double y) const;
+};
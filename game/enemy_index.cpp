@@ -0,0 +1,244 @@
+// Enemy spatial index: grid build, ray traversal and nearest-target search.
+#include "enemy_index.hpp"
+#include "../enemy/enemy_base.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const double kInf = std::numeric_limits<double>::infinity();
+    const double kMargin = 256; // Grid extent past the arena edges
+
+    // Ray/box slab test; on a hit the ray is inside the box from `t` (0 when
+    // it starts inside) to `t_out`
+    bool ray_box(double x, double y, double ux, double uy, double bx, double by, double bw, double bh, double &t,
+                 double &t_out)
+    {
+        double t0 = 0, t1 = kInf;
+        const double p[2] = {x, y}, u[2] = {ux, uy}, lo[2] = {bx, by}, hi[2] = {bx + bw, by + bh};
+        for (int a = 0; a < 2; ++a)
+        {
+            if (u[a] == 0)
+            {
+                if (p[a] < lo[a] || p[a] > hi[a])
+                    return false;
+                continue;
+            }
+            double ta = (lo[a] - p[a]) / u[a];
+            double tb = (hi[a] - p[a]) / u[a];
+            if (ta > tb) std::swap(ta, tb);
+            t0 = std::max(t0, ta);
+            t1 = std::min(t1, tb);
+            if (t0 > t1)
+                return false;
+        }
+        t = t0;
+        t_out = t1;
+        return true;
+    }
+}
+
+int EnemyIndex::col_of(double x) const
+{
+    return std::clamp((int)std::floor((x - origin_x_) / cell_), 0, cols_ - 1);
+}
+
+int EnemyIndex::row_of(double y) const
+{
+    return std::clamp((int)std::floor((y - origin_y_) / cell_), 0, rows_ - 1);
+}
+
+void EnemyIndex::rebuild(const std::vector<std::unique_ptr<EnemyBase>> &enemies, int width, int height)
+{
+    const int n = (int)enemies.size();
+    stale_ = false;
+
+    // Grid over the bounding box of the enemies' hurtboxes, clipped to the
+    // arena plus a margin
+    boxes_.resize(n);
+    double x0 = kInf, y0 = kInf, x1 = -kInf, y1 = -kInf;
+    for (int i = 0; i < n; ++i)
+    {
+        const EnemyBase *e = enemies[i].get();
+        if (!e || !e->alive)
+            continue;
+        const HitRect hurt = e->hurtbox();
+        boxes_[i] = {hurt.x, hurt.y, hurt.w, hurt.h, e->mask(), e->x, e->y};
+        const Box &b = boxes_[i];
+        x0 = std::min(x0, b.x);
+        y0 = std::min(y0, b.y);
+        x1 = std::max(x1, b.x + b.w);
+        y1 = std::max(y1, b.y + b.h);
+    }
+    if (x0 > x1)
+        x0 = y0 = x1 = y1 = 0;
+    x0 = std::max(x0, -kMargin);
+    y0 = std::max(y0, -kMargin);
+    x1 = std::min(x1, width + kMargin);
+    y1 = std::min(y1, height + kMargin);
+    origin_x_ = x0;
+    origin_y_ = y0;
+    cols_ = std::max(1, (int)std::ceil((x1 - x0) / cell_));
+    rows_ = std::max(1, (int)std::ceil((y1 - y0) / cell_));
+    const int cells = cols_ * rows_;
+
+    if ((int)seen_.size() < n)
+        seen_.resize(n, query_);
+
+    // Counting pass, prefix sums, then fill (buckets end up in enemy order)
+    start_.assign(cells + 1, 0);
+    for (int i = 0; i < n; ++i)
+    {
+        const EnemyBase *e = enemies[i].get();
+        if (!e || !e->alive)
+            continue;
+        const Box &b = boxes_[i];
+        for (int r = row_of(b.y); r <= row_of(b.y + b.h); ++r)
+            for (int c = col_of(b.x); c <= col_of(b.x + b.w); ++c)
+                start_[r * cols_ + c + 1]++;
+    }
+    for (int c = 0; c < cells; ++c)
+        start_[c + 1] += start_[c];
+
+    items_.resize(start_[cells]);
+    fill_.assign(start_.begin(), start_.end() - 1);
+    for (int i = 0; i < n; ++i)
+    {
+        const EnemyBase *e = enemies[i].get();
+        if (!e || !e->alive)
+            continue;
+        const Box &b = boxes_[i];
+        for (int r = row_of(b.y); r <= row_of(b.y + b.h); ++r)
+            for (int c = col_of(b.x); c <= col_of(b.x + b.w); ++c)
+                items_[fill_[r * cols_ + c]++] = i;
+    }
+}
+
+void EnemyIndex::next_query() const
+{
+    if (++query_ == 0)
+    {
+        std::fill(seen_.begin(), seen_.end(), 0);
+        query_ = 1;
+    }
+}
+
+void EnemyIndex::raycast(double x, double y, double ux, double uy, double max_t, std::vector<RayHit> &out) const
+{
+    out.clear();
+    if (cols_ == 0)
+        return;
+
+    // Each enemy is tested once per ray even when it spans several cells
+    next_query();
+
+    // Start in the cell holding the origin (clamped onto the grid) and step
+    // to whichever cell boundary the ray reaches first
+    int c = col_of(x), r = row_of(y);
+    int step_c = ux > 0 ? 1 : -1;
+    int step_r = uy > 0 ? 1 : -1;
+    double next_c = ux != 0 ? (origin_x_ + (c + (ux > 0)) * cell_ - x) / ux : kInf;
+    double next_r = uy != 0 ? (origin_y_ + (r + (uy > 0)) * cell_ - y) / uy : kInf;
+    double delta_c = ux != 0 ? cell_ / std::fabs(ux) : kInf;
+    double delta_r = uy != 0 ? cell_ / std::fabs(uy) : kInf;
+
+    double t_cell = 0; // Distance at which the ray entered the current cell
+    while (t_cell <= max_t)
+    {
+        const int cell = r * cols_ + c;
+        for (int k = start_[cell]; k < start_[cell + 1]; ++k)
+        {
+            int i = items_[k];
+            if (seen_[i] == query_)
+                continue;
+            seen_[i] = query_;
+            const Box &b = boxes_[i];
+            double t, t_out;
+            if (!ray_box(x, y, ux, uy, b.x, b.y, b.w, b.h, t, t_out) || t > max_t)
+                continue;
+            // Narrow phase: the first opaque pixel inside the box
+            if (b.mask && !b.mask->raycast(x - b.mask_x, y - b.mask_y, ux, uy, t, std::min(t_out, max_t), t))
+                continue;
+            out.push_back({i, t});
+        }
+
+        if (next_c < next_r)
+        {
+            c += step_c;
+            t_cell = next_c;
+            next_c += delta_c;
+        }
+        else
+        {
+            r += step_r;
+            t_cell = next_r;
+            next_r += delta_r;
+        }
+        if (c < 0 || c >= cols_ || r < 0 || r >= rows_)
+            break;
+    }
+
+    std::sort(out.begin(), out.end(), [](const RayHit &a, const RayHit &b) {
+        return a.t < b.t || (a.t == b.t && a.enemy < b.enemy);
+    });
+}
+
+int EnemyIndex::nearest(const TargetQuery &q) const
+{
+    if (cols_ == 0 || q.radius <= 0)
+        return -1;
+    next_query();
+
+    // The query's own cell, unclamped: a point off the grid searches inward.
+    // Everything outside rings 0..k lies more than k cells away, so the
+    // search ends when that distance reaches the best hit or the radius.
+    const int qc = (int)std::floor((q.x - origin_x_) / cell_);
+    const int qr = (int)std::floor((q.y - origin_y_) / cell_);
+    const int last_ring = std::max({qc, cols_ - 1 - qc, qr, rows_ - 1 - qr});
+    int best = -1;
+    double best_d2 = q.radius * q.radius;
+    for (int k = 0; k <= last_ring; ++k)
+    {
+        const double reach = (k - 1) * cell_; // Nearest any cell of ring k can be
+        if (k > 0 && reach * reach > best_d2)
+            break;
+        const int r0 = std::max(qr - k, 0), r1 = std::min(qr + k, rows_ - 1);
+        for (int r = r0; r <= r1; ++r)
+        {
+            // Whole rows at the ring's top and bottom, else its two side cells
+            const bool edge = r == qr - k || r == qr + k;
+            const int step = edge || k == 0 ? 1 : 2 * k;
+            for (int c = qc - k; c <= qc + k; c += step)
+            {
+                if (c < 0 || c >= cols_)
+                    continue;
+                const int cell = r * cols_ + c;
+                for (int j = start_[cell]; j < start_[cell + 1]; ++j)
+                {
+                    int i = items_[j];
+                    if (seen_[i] == query_)
+                        continue;
+                    seen_[i] = query_;
+                    const Box &b = boxes_[i];
+                    double dx = b.x + b.w / 2 - q.x, dy = b.y + b.h / 2 - q.y;
+                    double d2 = dx * dx + dy * dy;
+                    if (d2 > best_d2 || (d2 == best_d2 && (best == -1 || i > best)))
+                        continue;
+                    if (q.min_cos > -1 && d2 > 0 && dx * q.ux + dy * q.uy < q.min_cos * std::sqrt(d2))
+                        continue;
+                    best = i;
+                    best_d2 = d2;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+void EnemyIndex::nearest(const std::vector<TargetQuery> &queries, std::vector<int> &out) const
+{
+    out.resize(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+        out[i] = nearest(queries[i]);
+}
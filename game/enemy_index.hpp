@@ -0,0 +1,93 @@
+// Enemy spatial index: a uniform grid over the bounding box of the live
+// enemies (so its size follows the horde, not the arena) holding their
+// hurtboxes and pixel masks as of the rebuild.
+// update_world invalidates it every tick and the first query of
+// the tick rebuilds it, so ticks without queries pay nothing. Buckets are
+// stored flat (offset table plus one item array) and reused, so a rebuild
+// does not allocate once the arrays have grown.
+//
+// raycast walks only the cells the ray crosses (grid DDA), so a hitscan shot
+// costs the same however many enemies are on the field; a box it enters is
+// then checked against the mask rows the ray crosses inside it. nearest searches
+// rings of cells outward from the query point and stops once the next ring
+// cannot hold anything closer, so homing shots and aim assist look at a few
+// cells each, not at every enemy; a batch of queries shares one rebuild.
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class EnemyBase;
+class SpriteMask;
+
+// One enemy box crossed by a ray
+struct RayHit
+{
+    int enemy; // Index into world.enemies
+    double t;  // Distance along the ray where it enters the box (or mask)
+};
+
+// Nearest-target query: the enemy whose hurtbox centre is closest to (x, y),
+// within `radius` and, when min_cos > -1, inside the cone of half-angle
+// acos(min_cos) around the unit vector (ux, uy)
+struct TargetQuery
+{
+    double x = 0, y = 0;
+    double radius = 0;
+    double ux = 1, uy = 0;
+    double min_cos = -1; // -1: any direction
+};
+
+class EnemyIndex
+{
+public:
+    // Index the live enemies of a width x height arena (the grid stops a
+    // little past the arena; enemies beyond that go into the border cells)
+    void rebuild(const std::vector<std::unique_ptr<EnemyBase>> &enemies, int width, int height);
+
+    // Enemies have moved: the next refresh rebuilds
+    void invalidate() { stale_ = true; }
+
+    // Rebuild if invalidated since the last rebuild
+    void refresh(const std::vector<std::unique_ptr<EnemyBase>> &enemies, int width, int height)
+    {
+        if (stale_)
+            rebuild(enemies, width, height);
+    }
+
+    // Every indexed enemy whose box, and opaque pixels when its frame has a
+    // mask, the ray from (x, y) along the unit vector (ux, uy) reaches
+    // within max_t, nearest first. `out` is overwritten.
+    void raycast(double x, double y, double ux, double uy, double max_t, std::vector<RayHit> &out) const;
+
+    // Index into world.enemies of the target `q` asks for, or -1 (ties go to
+    // the lower index). Enemies killed since the rebuild still count: callers
+    // check `alive`.
+    int nearest(const TargetQuery &q) const;
+
+    // nearest for every query; `out[i]` answers `queries[i]` (overwritten)
+    void nearest(const std::vector<TargetQuery> &queries, std::vector<int> &out) const;
+
+private:
+    struct Box
+    {
+        double x, y, w, h;
+        const SpriteMask *mask; // Narrow phase (nullptr: the box is exact)
+        double mask_x, mask_y;  // Where the mask's top-left lies
+    };
+
+    double cell_ = 128;        // Cell size in pixels
+    bool stale_ = true;
+    int cols_ = 0, rows_ = 0;
+    double origin_x_ = 0, origin_y_ = 0; // Grid top-left, in arena coordinates
+    std::vector<Box> boxes_;   // Per enemy index: hurtbox as of the last rebuild
+    std::vector<int> start_;   // Bucket c holds items_[start_[c] .. start_[c + 1])
+    std::vector<int> items_;   // Enemy indices, bucket by bucket
+    std::vector<int> fill_;    // Rebuild scratch: next free item per bucket
+    mutable std::vector<uint32_t> seen_; // Per enemy: last query that tested it
+    mutable uint32_t query_ = 0;
+
+    int col_of(double x) const;
+    int row_of(double y) const;
+    void next_query() const;
+};
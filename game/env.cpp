@@ -0,0 +1,386 @@
+// Training environment implementation and its C bindings.
+#include "env.hpp"
+#include "autopilot.hpp"
+#include "../enemy/wave_schedule.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Reward shaping
+    const float reward_per_damage = 0.001f; // Per enemy hp removed
+    const float reward_kill = 1.0f;
+    const float reward_hit = -1.0f;         // Per heart lost
+    const float reward_wave = 5.0f;         // Wave cleared
+    const float reward_boss = 20.0f;        // Boss killed
+    const float reward_death = -5.0f;
+
+    // The K nearest candidates seen so far, nearest first. Insertion into a
+    // fixed array: no allocation, cheap for the small K used here.
+    struct Nearest
+    {
+        int idx;
+        double d2;
+    };
+
+    template <int K>
+    struct NearestK
+    {
+        Nearest items[K];
+        int count = 0;
+
+        void offer(int idx, double d2)
+        {
+            if (count == K && d2 >= items[K - 1].d2)
+                return;
+            int pos = count < K ? count++ : K - 1;
+            while (pos > 0 && items[pos - 1].d2 > d2)
+            {
+                items[pos] = items[pos - 1];
+                pos--;
+            }
+            items[pos] = {idx, d2};
+        }
+    };
+}
+
+TrainingEnv::TrainingEnv(EnvConfig cfg) : cfg_(cfg)
+{
+    world_.headless = true;
+    projectiles_.reserve(256);
+}
+
+void TrainingEnv::reset(uint64_t seed, float *obs)
+{
+    world_.rng.seed(seed);
+    load_world_assets(world_);
+    start_new_game(world_);
+    init_shop_items(shop_);
+    ticks_ = 0;
+    observe(obs);
+}
+
+// One game tick; returns its reward
+float TrainingEnv::tick(const InputState &in)
+{
+    auto &enemies = world_.enemies;
+    player_data &player = world_.player;
+
+    // Between waves: optionally shop, then straight into the next wave
+    if (!world_.wave_in_progress && !final_wave(world_))
+    {
+        if (cfg_.auto_shop)
+            autopilot_intermission(world_, shop_);
+        else
+            begin_next_wave(world_);
+    }
+
+    long hp_before = 0;
+    int alive_before = 0;
+    for (const auto &e : enemies)
+    {
+        if (!e->alive) continue;
+        hp_before += e->hp;
+        alive_before++;
+    }
+    const SpawnState &spawn = world_.spawn;
+    int spawned_before = spawn.last_wave == world_.wave ? spawn.spawned_this_wave : 0;
+    int hearts_before = player.hearts;
+    bool wave_before = world_.wave_in_progress;
+
+    update_world(world_, in);
+    update_coins(world_);
+    player.just_got_hit = false;
+    if (world_.block_flash_timer > 0) world_.block_flash_timer--;
+    if (world_.kill_marker_timer > 0) world_.kill_marker_timer--;
+
+    // The tick drops dead enemies and appends this tick's spawns at the end;
+    // only the enemies that were already there count
+    size_t n_old = enemies.size() - (spawn.spawned_this_wave - spawned_before);
+    long hp_after = 0;
+    int alive_after = 0;
+    for (size_t i = 0; i < n_old; ++i)
+    {
+        if (!enemies[i]->alive) continue;
+        hp_after += std::max(0, enemies[i]->hp);
+        alive_after++;
+    }
+
+    float r = 0;
+    r += reward_per_damage * (float)std::max(0L, hp_before - hp_after);
+    r += reward_kill * (float)std::max(0, alive_before - alive_after);
+    r += reward_hit * (float)std::max(0, hearts_before - player.hearts);
+    if (wave_before && !world_.wave_in_progress)
+        r += boss_wave(world_) ? reward_boss : reward_wave;
+    if (!player.alive)
+        r += reward_death;
+    return r;
+}
+
+EnvStepResult TrainingEnv::step(const ShooterAction &action, float *obs)
+{
+    const player_data &player = world_.player;
+    InputState in;
+    in.move_left = action.move_x < 0;
+    in.move_right = action.move_x > 0;
+    in.move_up = action.move_y < 0;
+    in.move_down = action.move_y > 0;
+    in.fire_down = action.fire != 0;
+    in.fire_clicked = action.fire != 0;
+    in.block_pressed = action.block != 0;
+    in.dash_pressed = action.dash != 0;
+
+    EnvStepResult res;
+    for (int f = 0; f < cfg_.frame_skip; ++f)
+    {
+        // Re-anchor the aim every tick so it follows the player
+        in.aim_x = player.player_x + player.player_width / 2.0 + action.aim_x * 100.0;
+        in.aim_y = player.player_y + player.player_hight / 2.0 + action.aim_y * 100.0;
+
+        res.reward += tick(in);
+        ticks_++;
+
+        // Edge-triggered inputs only act on the first repeated tick
+        in.block_pressed = false;
+        in.dash_pressed = false;
+
+        bool boss_dead = final_wave(world_) && !world_.wave_in_progress;
+        if (!player.alive || boss_dead)
+        {
+            res.done = true;
+            break;
+        }
+        if (ticks_ >= cfg_.max_ticks)
+        {
+            res.truncated = true;
+            break;
+        }
+    }
+    observe(obs);
+    return res;
+}
+
+void TrainingEnv::observe(float *obs)
+{
+    const player_data &player = world_.player;
+    const double aw = world_.arena_w, ah = world_.arena_h;
+    const double px = player.player_x + player.player_width / 2.0;
+    const double py = player.player_y + player.player_hight / 2.0;
+
+    std::fill(obs, obs + SHOOTER_OBS_SIZE, 0.0f);
+    float *o = obs;
+
+    int live = 0;
+    NearestK<SHOOTER_OBS_ENEMIES> near_e;
+    for (int i = 0; i < (int)world_.enemies.size(); ++i)
+    {
+        const EnemyBase &e = *world_.enemies[i];
+        if (!e.alive) continue;
+        live++;
+        double dx = e.x + e.width / 2.0 - px, dy = e.y + e.height / 2.0 - py;
+        near_e.offer(i, dx * dx + dy * dy);
+    }
+
+    o[0] = (float)(player.player_x / aw);
+    o[1] = (float)(player.player_y / ah);
+    o[2] = player.max_hearts > 0 ? (float)player.hearts / player.max_hearts : 0.0f;
+    o[3] = player.blocking ? 1.0f : 0.0f;
+    o[4] = player.is_dashing ? 1.0f : 0.0f;
+    o[5] = player.damage_cooldown > 0 ? 1.0f : 0.0f;
+    o[6] = world_.wave / (float)wave_count();
+    o[7] = live / 10.0f;
+    o += 8;
+
+    for (int k = 0; k < near_e.count; ++k)
+    {
+        const EnemyBase &e = *world_.enemies[near_e.items[k].idx];
+        float *row = o + k * 5;
+        row[0] = (float)((e.x + e.width / 2.0 - px) / aw);
+        row[1] = (float)((e.y + e.height / 2.0 - py) / ah);
+        row[2] = e.hp * 0.001f;
+        row[3] = e.telegraphing() ? 1.0f : 0.0f;
+        row[4] = 1.0f;
+    }
+    o += SHOOTER_OBS_ENEMIES * 5;
+
+    projectiles_.clear();
+    for (const auto &e : world_.enemies)
+        if (e->alive)
+            e->collect_projectiles(projectiles_);
+
+    NearestK<SHOOTER_OBS_PROJECTILES> near_p;
+    for (int i = 0; i < (int)projectiles_.size(); ++i)
+    {
+        double dx = projectiles_[i].x - px, dy = projectiles_[i].y - py;
+        near_p.offer(i, dx * dx + dy * dy);
+    }
+    for (int k = 0; k < near_p.count; ++k)
+    {
+        const ProjectileInfo &p = projectiles_[near_p.items[k].idx];
+        float *row = o + k * 5;
+        row[0] = (float)((p.x - px) / aw);
+        row[1] = (float)((p.y - py) / ah);
+        row[2] = (float)(p.dx / 10.0);
+        row[3] = (float)(p.dy / 10.0);
+        row[4] = 1.0f;
+    }
+}
+
+// ===== Vectorised form =====
+
+VecTrainingEnv::VecTrainingEnv(int num_envs, int num_threads, EnvConfig cfg, uint64_t seed)
+    : seed_(seed)
+{
+    int n = std::max(1, num_envs);
+    envs_.reserve(n);
+    for (int i = 0; i < n; ++i)
+        envs_.emplace_back(cfg);
+    episodes_.assign(n, 0);
+
+    int shards = std::max(1, std::min(num_threads, (int)envs_.size()));
+    for (int s = 1; s < shards; ++s)
+        workers_.emplace_back(&VecTrainingEnv::worker_loop, this, s);
+}
+
+VecTrainingEnv::~VecTrainingEnv()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        quit_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &t : workers_)
+        t.join();
+}
+
+void VecTrainingEnv::run_shard(int shard)
+{
+    int shards = (int)workers_.size() + 1;
+    int n = (int)envs_.size();
+    int begin = n * shard / shards, end = n * (shard + 1) / shards;
+    for (int i = begin; i < end; ++i)
+    {
+        float *obs = obs_ + (size_t)i * SHOOTER_OBS_SIZE;
+        if (resetting_)
+        {
+            envs_[i].reset(seed_for(i), obs);
+            continue;
+        }
+        EnvStepResult r = envs_[i].step(actions_[i], obs);
+        rewards_[i] = r.reward;
+        dones_[i] = (r.done || r.truncated) ? 1 : 0;
+        if (dones_[i])
+        {
+            episodes_[i]++;
+            envs_[i].reset(seed_for(i), obs);
+        }
+    }
+}
+
+void VecTrainingEnv::worker_loop(int shard)
+{
+    unsigned long seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            start_cv_.wait(lock, [&] { return quit_ || generation_ != seen; });
+            if (quit_)
+                return;
+            seen = generation_;
+        }
+        run_shard(shard);
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (--pending_ == 0)
+                done_cv_.notify_one();
+        }
+    }
+}
+
+void VecTrainingEnv::dispatch()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        pending_ = (int)workers_.size();
+        generation_++;
+    }
+    start_cv_.notify_all();
+    run_shard(0);
+    std::unique_lock<std::mutex> lock(mtx_);
+    done_cv_.wait(lock, [&] { return pending_ == 0; });
+}
+
+void VecTrainingEnv::reset(float *obs)
+{
+    obs_ = obs;
+    resetting_ = true;
+    dispatch();
+    resetting_ = false;
+}
+
+void VecTrainingEnv::step(const ShooterAction *actions, float *obs, float *rewards, uint8_t *dones)
+{
+    actions_ = actions;
+    obs_ = obs;
+    rewards_ = rewards;
+    dones_ = dones;
+    dispatch();
+}
+
+// ===== C bindings =====
+
+struct ShooterEnv
+{
+    TrainingEnv env;
+    explicit ShooterEnv(EnvConfig cfg) : env(cfg) {}
+};
+
+struct ShooterVecEnv
+{
+    VecTrainingEnv vec;
+    ShooterVecEnv(int num_envs, int num_threads, EnvConfig cfg, uint64_t seed)
+        : vec(num_envs, num_threads, cfg, seed) {}
+};
+
+static EnvConfig config_with_skip(int frame_skip)
+{
+    EnvConfig cfg;
+    cfg.frame_skip = frame_skip > 0 ? frame_skip : 1;
+    return cfg;
+}
+
+extern "C" {
+
+ShooterEnv *shooter_env_create(int frame_skip)
+{
+    return new ShooterEnv(config_with_skip(frame_skip));
+}
+
+void shooter_env_destroy(ShooterEnv *env) { delete env; }
+
+void shooter_env_reset(ShooterEnv *env, uint64_t seed, float *obs) { env->env.reset(seed, obs); }
+
+int shooter_env_step(ShooterEnv *env, const ShooterAction *action, float *obs, float *reward)
+{
+    EnvStepResult r = env->env.step(*action, obs);
+    if (reward) *reward = r.reward;
+    return (r.done || r.truncated) ? 1 : 0;
+}
+
+ShooterVecEnv *shooter_vec_create(int num_envs, int num_threads, int frame_skip, uint64_t seed)
+{
+    return new ShooterVecEnv(num_envs, num_threads, config_with_skip(frame_skip), seed);
+}
+
+void shooter_vec_destroy(ShooterVecEnv *vec) { delete vec; }
+
+void shooter_vec_reset(ShooterVecEnv *vec, float *obs) { vec->vec.reset(obs); }
+
+void shooter_vec_step(ShooterVecEnv *vec, const ShooterAction *actions,
+                      float *obs, float *rewards, uint8_t *dones)
+{
+    vec->vec.step(actions, obs, rewards, dones);
+}
+
+}
@@ -0,0 +1,86 @@
+// Training environment: gym-style reset/step over a headless GameWorld, and a
+// vectorised form that steps many worlds in lockstep on persistent threads.
+// After reset, stepping performs no heap allocation in steady state: bullets,
+// arrows, boss shots and coins reuse their slots, and the observation
+// scratch buffers keep their capacity. (Spawning an enemy still allocates the
+// enemy object, at most once per spawn interval, and reset() rebuilds the
+// default loadout.)
+#pragma once
+#include "game_world.hpp"
+#include "shooter_env.h"
+#include "../ui/shop.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct EnvConfig
+{
+    int frame_skip = 1;                // Game ticks per step (action repeated)
+    long max_ticks = 120L * 60 * 30;   // Truncate episodes after 30 min of game time
+    bool auto_shop = true;             // Buy the best affordable weapon between waves
+};
+
+struct EnvStepResult
+{
+    float reward = 0;
+    bool done = false;      // Player died or boss killed
+    bool truncated = false; // Hit max_ticks
+};
+
+class TrainingEnv
+{
+public:
+    explicit TrainingEnv(EnvConfig cfg = EnvConfig());
+
+    void reset(uint64_t seed, float *obs);
+    EnvStepResult step(const ShooterAction &action, float *obs);
+
+    const GameWorld &world() const { return world_; }
+
+private:
+    EnvConfig cfg_;
+    GameWorld world_;
+    ShopState shop_;
+    long ticks_ = 0;
+    std::vector<ProjectileInfo> projectiles_; // Scratch, capacity kept between steps
+
+    float tick(const InputState &in);
+    void observe(float *obs);
+};
+
+class VecTrainingEnv
+{
+public:
+    VecTrainingEnv(int num_envs, int num_threads, EnvConfig cfg, uint64_t seed);
+    ~VecTrainingEnv();
+
+    int size() const { return (int)envs_.size(); }
+    void reset(float *obs);
+    void step(const ShooterAction *actions, float *obs, float *rewards, uint8_t *dones);
+
+private:
+    std::vector<TrainingEnv> envs_;
+    std::vector<uint64_t> episodes_; // Episodes finished per env (seed derivation)
+    uint64_t seed_;
+
+    // Persistent workers; main thread takes shard 0
+    std::vector<std::thread> workers_;
+    std::mutex mtx_;
+    std::condition_variable start_cv_, done_cv_;
+    unsigned long generation_ = 0;
+    int pending_ = 0;
+    bool quit_ = false;
+
+    // Current job (valid while pending_ > 0)
+    const ShooterAction *actions_ = nullptr;
+    float *obs_ = nullptr;
+    float *rewards_ = nullptr;
+    uint8_t *dones_ = nullptr;
+    bool resetting_ = false;
+
+    uint64_t seed_for(int i) const { return seed_ + (uint64_t)i + episodes_[i] * envs_.size(); }
+    void run_shard(int shard);
+    void worker_loop(int shard);
+    void dispatch();
+};
@@ -0,0 +1,445 @@
+// Flow field toward the player: grid build, Dijkstra and sampling.
+#include "flow_field.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+
+namespace
+{
+    const double kInf = std::numeric_limits<double>::infinity();
+    const double kDiagonal = std::sqrt(2.0);
+    const int kUnreached = std::numeric_limits<int>::max();
+
+    // The eight moves: straight ones first, then diagonals
+    const int kMoveC[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+    const int kMoveR[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+    // Unit vector and length from (x0, y0) to (x1, y1)
+    FlowField::Step toward(double x0, double y0, double x1, double y1)
+    {
+        FlowField::Step s;
+        double dx = x1 - x0, dy = y1 - y0;
+        s.dist = std::sqrt(dx * dx + dy * dy);
+        if (s.dist > 0)
+        {
+            s.dx = dx / s.dist;
+            s.dy = dy / s.dist;
+        }
+        return s;
+    }
+}
+
+int FlowField::col_of(double x) const
+{
+    return std::clamp((int)std::floor((x - origin_x_) / cell_), 0, cols_ - 1);
+}
+
+int FlowField::row_of(double y) const
+{
+    return std::clamp((int)std::floor((y - origin_y_) / cell_), 0, rows_ - 1);
+}
+
+void FlowField::update(double goal_x, double goal_y, double x0, double y0, double width, double height)
+{
+    // Snap the window to whole steps and pad it by one, so it still covers
+    // the region wherever the region sits inside a step
+    const double step = cell_ * snap_;
+    const double ox = std::floor(x0 / step) * step, oy = std::floor(y0 / step) * step;
+    const int w = (int)((std::ceil(width / step) + 1) * step), h = (int)((std::ceil(height / step) + 1) * step);
+    const bool moved = ox != origin_x_ || oy != origin_y_;
+    origin_x_ = ox;
+    origin_y_ = oy;
+    if (w != width_ || h != height_)
+        resize(w, h);
+    else if (moved)
+        move_window();
+    goal_x_ = goal_x;
+    goal_y_ = goal_y;
+    int goal = row_of(goal_y) * cols_ + col_of(goal_x);
+    if (goal != goal_cell_)
+    {
+        goal_cell_ = goal;
+        stale_ = true; // Cells are worked out again as they are sampled
+    }
+}
+
+void FlowField::add_obstacle(double x, double y, double w, double h)
+{
+    obstacles_.push_back({x, y, w, h});
+    spare_.valid = false;
+    rasterise();
+}
+
+void FlowField::clear_obstacles()
+{
+    obstacles_.clear();
+    spare_.valid = false;
+    rasterise();
+}
+
+// New window size; the next update rebuilds
+void FlowField::resize(int width, int height)
+{
+    width_ = width;
+    height_ = height;
+    cols_ = std::max(1, (int)std::ceil(width / cell_));
+    rows_ = std::max(1, (int)std::ceil(height / cell_));
+    const int n = cols_ * rows_;
+    cells_.assign(n, Cell());
+    spare_.valid = false;
+
+    // Straight-line steering for every cell offset from the goal cell
+    offsets_.assign((2 * cols_ - 1) * (2 * rows_ - 1), Cell());
+    for (int r = 0; r < 2 * rows_ - 1; ++r)
+        for (int c = 0; c < 2 * cols_ - 1; ++c)
+        {
+            Step s = toward(0, 0, (cols_ - 1 - c) * cell_, (rows_ - 1 - r) * cell_);
+            offsets_[r * (2 * cols_ - 1) + c] = {s.dx, s.dy, s.dist, true};
+        }
+
+    // Moves that stay inside the window, before obstacles close any
+    open_moves_.assign(n, 0);
+    for (int r = 0; r < rows_; ++r)
+        for (int c = 0; c < cols_; ++c)
+            for (int k = 0; k < 8; ++k)
+            {
+                const int nc = c + kMoveC[k], nr = r + kMoveR[k];
+                if (nc >= 0 && nc < cols_ && nr >= 0 && nr < rows_)
+                    open_moves_[r * cols_ + c] |= 1 << k;
+            }
+    rasterise();
+}
+
+// The window moved: take back the layout it had there before if it still
+// holds one (the player going back and forth over a step boundary), keeping
+// the one it leaves for the same reason
+void FlowField::move_window()
+{
+    std::swap(layout_, spare_);
+    if (!layout_.valid || layout_.x != origin_x_ || layout_.y != origin_y_)
+        rasterise();
+    goal_cell_ = -1;
+    search_ = nullptr;
+}
+
+// Blocked cells and allowed moves for the window's current position, with no
+// searches run yet
+void FlowField::rasterise()
+{
+    goal_cell_ = -1;
+    search_ = nullptr;
+    layout_.valid = true;
+    layout_.x = origin_x_;
+    layout_.y = origin_y_;
+    for (Search &s : layout_.searches)
+        s.start = -1;
+
+    // Obstacles outside the window are left out, not clamped onto its border.
+    // With none inside, only the offset table is read: skip the per-cell work.
+    auto inside = [&](const Box &b) {
+        return b.x + b.w >= origin_x_ && b.x < origin_x_ + width_ && b.y + b.h >= origin_y_ && b.y < origin_y_ + height_;
+    };
+    layout_.blocked_count = 0;
+    if (std::none_of(obstacles_.begin(), obstacles_.end(), inside))
+        return;
+
+    const int n = cols_ * rows_;
+    std::vector<uint8_t> &blocked = layout_.blocked;
+    std::vector<int> &blocked_sum = layout_.blocked_sum;
+    std::vector<uint8_t> &moves = layout_.moves;
+    blocked.assign(n, 0);
+    for (const Box &b : obstacles_)
+    {
+        if (!inside(b))
+            continue;
+        // Cells the box overlaps; one that only touches its far edge stays open
+        const int c1 = std::min(cols_ - 1, (int)std::ceil((b.x + b.w - origin_x_) / cell_) - 1);
+        const int r1 = std::min(rows_ - 1, (int)std::ceil((b.y + b.h - origin_y_) / cell_) - 1);
+        for (int r = row_of(b.y); r <= r1; ++r)
+            for (int c = col_of(b.x); c <= c1; ++c)
+                blocked[r * cols_ + c] = 1;
+    }
+
+    const int w = cols_ + 1;
+    blocked_sum.assign(w * (rows_ + 1), 0);
+    for (int r = 0; r < rows_; ++r)
+        for (int c = 0; c < cols_; ++c)
+            blocked_sum[(r + 1) * w + c + 1] = blocked[r * cols_ + c] + blocked_sum[r * w + c + 1] +
+                                               blocked_sum[(r + 1) * w + c] - blocked_sum[r * w + c];
+    layout_.blocked_count = blocked_sum.back();
+
+    // Allowed moves per cell, starting from the open window: each blocked
+    // cell closes the moves into it and the diagonals cutting its corners, so
+    // the cost follows the obstacles rather than the window
+    auto close = [&](int c, int r, int k) {
+        if (c >= 0 && c < cols_ && r >= 0 && r < rows_)
+            moves[r * cols_ + c] &= ~(1 << k);
+    };
+    moves = open_moves_;
+    for (int r = 0; r < rows_; ++r)
+        for (int c = 0; c < cols_; ++c)
+        {
+            if (!blocked[r * cols_ + c])
+                continue;
+            for (int k = 0; k < 8; ++k)
+            {
+                close(c - kMoveC[k], r - kMoveR[k], k);
+                if (k >= 4)
+                {
+                    close(c - kMoveC[k], r, k);
+                    close(c, r - kMoveR[k], k);
+                }
+            }
+        }
+}
+
+// Blocked cells in the box spanned by two cells (inclusive, any order)
+int FlowField::blocked_in(int c0, int r0, int c1, int r1) const
+{
+    if (c0 > c1) std::swap(c0, c1);
+    if (r0 > r1) std::swap(r0, r1);
+    const int w = cols_ + 1;
+    const std::vector<int> &sum = layout_.blocked_sum;
+    return sum[(r1 + 1) * w + c1 + 1] - sum[r0 * w + c1 + 1] - sum[(r1 + 1) * w + c0] + sum[r0 * w + c0];
+}
+
+// Whether the segment between the centres of (c, r) and the goal cell
+// crosses only open cells (through a corner, both cells beside it must be open)
+bool FlowField::sees_goal(int c, int r, int gc, int gr) const
+{
+    // Nothing blocked in the box the segment stays inside: no walk needed
+    if (blocked_in(c, r, gc, gr) == 0)
+        return true;
+    auto blocked = [&](int cc, int rr) { return layout_.blocked[rr * cols_ + cc] != 0; };
+    double dx = gc - c, dy = gr - r;
+    int step_c = dx > 0 ? 1 : -1;
+    int step_r = dy > 0 ? 1 : -1;
+    double next_c = dx != 0 ? 0.5 / std::fabs(dx) : kInf;
+    double next_r = dy != 0 ? 0.5 / std::fabs(dy) : kInf;
+    double delta_c = dx != 0 ? 1 / std::fabs(dx) : kInf;
+    double delta_r = dy != 0 ? 1 / std::fabs(dy) : kInf;
+    while (c != gc || r != gr)
+    {
+        if (blocked(c, r))
+            return false;
+        if (next_c < next_r)
+        {
+            c += step_c;
+            next_c += delta_c;
+        }
+        else if (next_r < next_c)
+        {
+            r += step_r;
+            next_r += delta_r;
+        }
+        else
+        {
+            if (blocked(c + step_c, r) || blocked(c, r + step_r))
+                return false;
+            c += step_c;
+            r += step_r;
+            next_c += delta_c;
+            next_r += delta_r;
+        }
+    }
+    return !blocked(c, r);
+}
+
+const FlowField::Cell &FlowField::offset_cell(int c, int r, int gc, int gr) const
+{
+    return offsets_[(r - gr + rows_ - 1) * (2 * cols_ - 1) + (c - gc + cols_ - 1)];
+}
+
+int FlowField::move_step(int k) const
+{
+    return kMoveR[k] * cols_ + kMoveC[k];
+}
+
+// Forget every cell's direction; each is worked out again on first use (see
+// resolve)
+void FlowField::forget_cells()
+{
+    const int n = cols_ * rows_;
+    if ((int)stamp_.size() != n)
+        stamp_.assign(n, epoch_);
+    if (++epoch_ == 0)
+    {
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        epoch_ = 1;
+    }
+}
+
+// Cell the search starts from. Paths only have to bring an enemy within
+// sight of the goal, so any open cell of the goal's block of search_block_ x
+// search_block_ cells that sees the goal cell will do: the centre if it can,
+// else the first such cell in row order. The search then runs again only when
+// the goal enters another block or the cell loses sight of it, and not even
+// then if the block's search is still kept (see find_search). A goal hemmed
+// in by obstacles is searched from directly.
+int FlowField::search_start() const
+{
+    const int gc = goal_cell_ % cols_, gr = goal_cell_ / cols_;
+    const int c0 = gc / search_block_ * search_block_, r0 = gr / search_block_ * search_block_;
+    auto usable = [&](int c, int r) {
+        return c < cols_ && r < rows_ && !layout_.blocked[r * cols_ + c] && sees_goal(c, r, gc, gr);
+    };
+    const int mid = search_block_ / 2;
+    if (usable(c0 + mid, r0 + mid))
+        return (r0 + mid) * cols_ + c0 + mid;
+    for (int r = r0; r < r0 + search_block_; ++r)
+        for (int c = c0; c < c0 + search_block_; ++c)
+            if (usable(c, r))
+                return r * cols_ + c;
+    return goal_cell_;
+}
+
+// The kept search from search_goal_, if any. The last kSearches searches of
+// the layout are kept, so a goal moving between a few blocks (the player
+// circling, or dodging across a block edge) picks up where it left off.
+FlowField::Search *FlowField::find_search()
+{
+    for (Search &s : layout_.searches)
+        if (s.start == search_goal_)
+        {
+            s.used = uses_;
+            return &s;
+        }
+    return nullptr;
+}
+
+// Start a search from search_goal_ in the least recently used slot; cells are
+// settled on demand (see settle)
+void FlowField::rebuild()
+{
+    Search *s = &layout_.searches[0];
+    for (Search &t : layout_.searches)
+    {
+        if (t.start < 0)
+        {
+            s = &t;
+            break;
+        }
+        if (t.used < s->used)
+            s = &t;
+    }
+    s->start = search_goal_;
+    s->used = uses_;
+    s->cost.assign(cols_ * rows_, kUnreached);
+    for (std::vector<int> &bucket : s->ring)
+        bucket.clear();
+    s->cost[search_goal_] = 0;
+    s->ring[0].push_back(search_goal_);
+    s->d = 0;
+    s->queued = 1;
+    search_ = s;
+}
+
+// Run the search until cell i's path cost is final (or it proves cut off).
+// Integer step costs (5 straight, 7 diagonal) let a ring of buckets replace
+// the heap: every step lands 5-7 buckets ahead of the one being expanded, and
+// a cell is final once its bucket is done. Enemies cluster around the
+// player, so the search usually stops well short of the window edges.
+void FlowField::settle(int target)
+{
+    Search &s = *search_;
+    std::vector<int> &cost = s.cost;
+    const uint8_t *moves = layout_.moves.data();
+    while (s.queued > 0 && (cost[target] == kUnreached || cost[target] >= s.d))
+    {
+        const int d = s.d++;
+        std::vector<int> &bucket = s.ring[d & 7];
+        for (size_t q = 0; q < bucket.size(); ++q)
+        {
+            const int i = bucket[q];
+            --s.queued;
+            if (cost[i] != d)
+                continue; // Reached more cheaply since it was queued
+            for (int k = 0; k < 8; ++k)
+            {
+                if (!(moves[i] >> k & 1))
+                    continue;
+                const int j = i + move_step(k);
+                const int nd = d + (k < 4 ? 5 : 7);
+                if (nd < cost[j])
+                {
+                    cost[j] = nd;
+                    s.ring[nd & 7].push_back(j);
+                    ++s.queued;
+                }
+            }
+        }
+        bucket.clear();
+    }
+}
+
+// Direction of cell i for the current goal: straight at the goal where the
+// line is clear, otherwise towards the cheapest neighbour. A blocked cell (an
+// enemy pushed into one) steps out to its cheapest open neighbour; cut-off
+// cells just head at the goal. The search only runs once some cell needs it.
+const FlowField::Cell &FlowField::resolve(int i)
+{
+    if (stale_)
+    {
+        forget_cells();
+        stale_ = false;
+        ++uses_;
+        search_goal_ = search_start();
+        search_ = find_search();
+    }
+    Cell &cell = cells_[i];
+    if (stamp_[i] == epoch_)
+        return cell;
+    stamp_[i] = epoch_;
+
+    const int c = i % cols_, r = i / cols_;
+    const int gc = goal_cell_ % cols_, gr = goal_cell_ / cols_;
+    const bool blocked = layout_.blocked[i] != 0;
+    const bool direct = !blocked && sees_goal(c, r, gc, gr);
+    if (!direct && !search_)
+        rebuild();
+    int best = -1;
+    if (!direct)
+    {
+        const std::vector<int> &cost = search_->cost;
+        for (int k = 0; k < 8; ++k)
+        {
+            if (!(layout_.moves[i] >> k & 1))
+                continue;
+            settle(i + move_step(k));
+            if (cost[i + move_step(k)] != kUnreached && (best < 0 || cost[i + move_step(k)] < cost[i + move_step(best)]))
+                best = k;
+        }
+        if (!blocked)
+            settle(i);
+    }
+    if (best < 0)
+    {
+        cell = offset_cell(c, r, gc, gr);
+        cell.direct = direct;
+        return cell;
+    }
+    const double len = best < 4 ? 1 : kDiagonal;
+    const int step = best < 4 ? 5 : 7;
+    const std::vector<int> &cost = search_->cost;
+    const int dist = blocked ? cost[i + move_step(best)] + step : cost[i];
+    cell = {kMoveC[best] / len, kMoveR[best] / len, dist * cell_ / 5, false};
+    return cell;
+}
+
+FlowField::Step FlowField::sample(double x, double y)
+{
+    if (goal_cell_ < 0 || x < origin_x_ || y < origin_y_ || x >= origin_x_ + width_ || y >= origin_y_ + height_)
+        return toward(x, y, goal_x_, goal_y_);
+    const int c = col_of(x), r = row_of(y);
+    const int gc = goal_cell_ % cols_, gr = goal_cell_ / cols_;
+    const Cell &cell = layout_.blocked_count == 0 ? offset_cell(c, r, gc, gr) : resolve(r * cols_ + c);
+    if (cell.direct && std::abs(c - gc) <= near_ && std::abs(r - gr) <= near_)
+        return toward(x, y, goal_x_, goal_y_);
+    Step s;
+    s.dx = cell.dx;
+    s.dy = cell.dy;
+    s.dist = cell.dist;
+    return s;
+}
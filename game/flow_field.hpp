@@ -0,0 +1,125 @@
+// Flow field toward the player: a coarse grid over the simulation's active
+// region (a window around the view, not the whole arena) where every cell
+// holds the direction to walk and the path length left. update_world refreshes
+// it every tick, but the field only changes when the player enters another
+// cell, the window moves or the obstacles change, so chasing enemies just look
+// up their cell. The window moves in steps of several cells, and its cost
+// depends on its size only, however large the arena is.
+//
+// Cells that can see the goal cell point straight at its centre; the others
+// follow a Dijkstra search (8-neighbour, no corner cutting) around blocked
+// cells. Without obstacles the field is the same for every goal cell up to a
+// shift, so it is read from one offset table and a move costs nothing. With
+// obstacles a cell's direction is worked out the first time an enemy stands
+// in it. The search only runs once one of them cannot see the goal, expands
+// only as far as the enemies asking, and is shared by nearby goal cells. It
+// is kept across ticks: the last few searches stay with the rasterised
+// obstacles of the window position they ran over, and the layout of the
+// previous position is kept too, so the player walking back over a block or
+// step boundary finds them settled.
+//
+// The field depends only on the goal cell and the obstacles, never on when it
+// was built, so it is derived state and not saved in snapshots. Near the
+// player, and outside the window, the exact direction is used instead.
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class FlowField
+{
+public:
+    // Direction to move (unit vector, zero at the goal) and distance left
+    struct Step
+    {
+        double dx = 0, dy = 0;
+        double dist = 0;
+    };
+
+    // Follow the goal point over (at least) the region with top-left corner
+    // (x0, y0) and size width x height
+    void update(double goal_x, double goal_y, double x0, double y0, double width, double height);
+
+    // Static obstacles: the cells a rectangle overlaps become impassable
+    void add_obstacle(double x, double y, double w, double h);
+    void clear_obstacles();
+
+    // Steering for an enemy whose reference point is (x, y)
+    Step sample(double x, double y);
+
+private:
+    struct Box
+    {
+        double x, y, w, h;
+    };
+    struct Cell
+    {
+        double dx = 0, dy = 0; // Unit direction toward the goal cell
+        double dist = 0;       // Path length to the goal cell centre
+        bool direct = false;   // Straight line to the goal cell is clear
+    };
+
+    double cell_ = 32;               // Cell size in pixels
+    int near_ = 2;                   // Cells around the goal that steer exactly
+    int snap_ = 8;                   // The window moves in steps of this many cells
+    int cols_ = 0, rows_ = 0;
+    int width_ = 0, height_ = 0;     // Window size
+    double origin_x_ = 0, origin_y_ = 0; // Window top-left, in arena coordinates
+    int goal_cell_ = -1;             // Goal cell (-1: not placed yet)
+    double goal_x_ = 0, goal_y_ = 0; // Live goal point
+
+    // One search from `start`, settled as far as enemies have asked so far
+    struct Search
+    {
+        int start = -1;             // Cell it starts from (-1: slot unused)
+        uint32_t used = 0;          // When it last served a goal, for eviction
+        std::vector<int> cost;      // Path cost per cell, in fifths of a cell (final below d)
+        std::vector<int> ring[8];   // Dijkstra bucket queue (step costs 5 and 7)
+        int d = 0;                  // Next bucket the search expands
+        int queued = 0;             // Entries left in ring
+    };
+    static const int kSearches = 8; // Searches kept per layout
+
+    // The obstacles rasterised for one window position, and the searches
+    // run over them
+    struct Layout
+    {
+        bool valid = false;
+        double x = 0, y = 0;           // Window top-left it is for
+        std::vector<uint8_t> blocked;  // Per cell, rasterised from obstacles_
+        std::vector<int> blocked_sum;  // Summed-area table of blocked
+        std::vector<uint8_t> moves;    // Per cell: bit k set if move k is open
+        int blocked_count = 0;
+        Search searches[kSearches];
+    };
+
+    std::vector<Box> obstacles_;
+    Layout layout_;                  // For the window's position
+    Layout spare_;                   // For the position before, kept for a move back
+    std::vector<uint8_t> open_moves_; // Layout moves with no obstacles (window edges only)
+    std::vector<Cell> offsets_;      // Open arena: per (cell - goal cell) offset
+
+    bool stale_ = true;              // Cell directions are for an older goal
+    int search_goal_ = -1;           // Cell the search starts from (see search_start)
+    int search_block_ = 4;           // Goal blocks sharing one search, in cells per side
+    Search *search_ = nullptr;       // Search from search_goal_, once one has run
+    uint32_t uses_ = 0;              // Goals served, for Search::used
+    std::vector<Cell> cells_;        // Per cell, for the current goal
+    std::vector<uint32_t> stamp_;    // Per cell: epoch its cells_ entry is for
+    uint32_t epoch_ = 0;             // Bumped by every goal change
+
+    int col_of(double x) const;
+    int row_of(double y) const;
+    void resize(int width, int height);
+    void move_window();
+    void rasterise();
+    void forget_cells();
+    int search_start() const;
+    Search *find_search();
+    void rebuild();
+    void settle(int target);
+    const Cell &resolve(int i);
+    int move_step(int k) const;
+    const Cell &offset_cell(int c, int r, int gc, int gr) const;
+    int blocked_in(int c0, int r0, int c1, int r1) const;
+    bool sees_goal(int c, int r, int gc, int gr) const;
+};
@@ -0,0 +1,407 @@
+// GameWorld tick: the gameplay part of the frame, independent of menus and drawing.
+#include "game_world.hpp"
+#include "../enemy/enemy_spawn.hpp"
+#include "../weapon/weapon_registry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+
+const int wave_clear_delay = 360; // Frames between waves
+
+// Crowd separation tuning
+const int crowd_neighbours = 8;      // Neighbours considered per enemy (grid queries)
+const int crowd_small = 16;          // Up to this many, every pair is checked directly
+const double crowd_spacing = 0.6;    // Wanted centre distance, in average widths
+const double crowd_max_push = 1.5;   // Pixels an enemy is pushed per frame at most
+
+const double flow_clearance = 64; // Chaser box size kept clear of obstacles by the flow field
+
+// Aim assist tuning
+const double assist_range = 900;  // Farthest enemy the aim is pulled onto
+const double assist_cone_deg = 8; // Half-angle around the aim line
+
+void load_world_assets(GameWorld &world)
+{
+    world.coin_frames.clear();
+    if (world.headless)
+        return;
+
+    // Coin animation frames, loaded once and shared by every dropped coin
+    for (int i = 1; i <= 10; ++i)
+    {
+        std::string name = "coin_" + std::to_string(i);
+        load_bitmap(name, "../image/ui/coin" + std::to_string(i) + ".png");
+        world.coin_frames.push_back(bitmap_named(name));
+    }
+
+    // Every enemy kind's sprites, up front: enemies spawn on the simulation
+    // thread, which never loads bitmaps itself
+    for (int k = 0; k < kEnemyKinds; ++k)
+        load_enemy_sprites((EnemyKind)k);
+}
+
+void start_new_game(GameWorld &world, bool endless)
+{
+    world.endless = endless;
+    world.money = 0;
+    world.wave = 1;
+    world.wave_in_progress = true;
+    world.wave_clear_timer = 0;
+    world.wave_cleared_prompt = false;
+    reset_spawn_state(world.spawn);
+    world.enemies.clear();
+    world.coins.clear();
+    world.free_coins.clear();
+    world.camera_shake_timer = 0;
+    world.kill_marker_timer = 0;
+    world.block_flash_timer = 0;
+
+    // default weapons
+    world.weapons.clear();
+    auto ak = create_weapon(WeaponType::AK);
+    auto pistol = create_weapon(WeaponType::Pistol);
+    if (!world.headless)
+    {
+        ak->load_assets();
+        pistol->load_assets();
+    }
+    world.weapons.push_back(std::move(ak));
+    world.weapons.push_back(std::move(pistol));
+    world.current_weapon = 0;
+
+    // reset player state
+    reset_player_state(world.player);
+    world.player.player_x = world.arena_w / 2.0;
+    world.player.player_y = world.arena_h / 2.0;
+}
+
+void begin_next_wave(GameWorld &world)
+{
+    world.wave_cleared_prompt = false;
+    world.wave++;
+    world.wave_in_progress = true;
+    world.wave_clear_timer = wave_clear_delay;
+}
+
+const AnimClip &coin_clip()
+{
+    static const AnimClip clip = AnimClip::uniform(10, 20, true); // 20 frames per coin frame
+    return clip;
+}
+
+void spawn_coin(GameWorld &world, double x, double y, double value)
+{
+    Coin c;
+    c.x = x;               // Coin X position
+    c.y = y;               // Coin Y position
+    c.value = value;       // Money this coin gives
+    c.active = true;       // Activate coin
+    c.anim = {};           // Spin from the first frame
+
+    // Reuse the lowest collected coin's slot before growing the list
+    if (!world.free_coins.empty())
+    {
+        std::pop_heap(world.free_coins.begin(), world.free_coins.end(), std::greater<int>());
+        world.coins[world.free_coins.back()] = c;
+        world.free_coins.pop_back();
+        return;
+    }
+    world.coins.push_back(c);
+}
+
+int active_weapon_index(GameWorld &world)
+{
+    auto &weapons = world.weapons;
+    int active_idx = world.current_weapon;
+    if (active_idx >= (int)weapons.size() || !weapons[active_idx])
+    {
+        if (weapons.size() > 0 && weapons[0]) active_idx = 0;
+        else if (weapons.size() > 1 && weapons[1]) active_idx = 1;
+        else active_idx = -1;
+        if (active_idx != -1) world.current_weapon = active_idx;
+    }
+    return active_idx;
+}
+
+void silence_weapons(GameWorld &world, int except)
+{
+    for (int i = 0; i < (int)world.weapons.size(); ++i)
+        if (i != except && world.weapons[i])
+            world.weapons[i]->silence(world);
+}
+
+// Swept bullet hits: each live bullet is cast along the segment it covered
+// this tick through the enemy index, and the enemies it crosses are hit in
+// time-of-impact order. A normal bullet stops at the first enemy that takes
+// the hit; a piercing one carries on, losing damage per hit, until its
+// pierce limit runs out. Obstacles cut the segment short: enemies behind
+// the wall it reaches are out of its path, and a bullet that is not spent
+// before then stops at the wall.
+static void resolve_bullet_hits(GameWorld &world, std::vector<Bullet> &bullets)
+{
+    EnemyIndex &index = world.enemy_index;
+    for (auto &b : bullets)
+    {
+        if (!b.active)
+            continue;
+        double len = std::sqrt(b.dx * b.dx + b.dy * b.dy);
+        if (len == 0)
+            continue;
+        double ux = b.dx / len, uy = b.dy / len;
+        double ox = b.x - b.dx, oy = b.y - b.dy;
+        double wall = len;
+        bool blocked = world.obstacles->raycast(ox, oy, ux, uy, len, wall);
+
+        index.refresh(world.enemies, world.arena_w, world.arena_h);
+        index.raycast(ox, oy, ux, uy, wall, world.ray_hits);
+        for (const RayHit &h : world.ray_hits)
+        {
+            // A piercing bullet already inside an enemy hit it on entry
+            if (b.piercing && h.t == 0)
+                continue;
+            EnemyBase &e = *world.enemies[h.enemy];
+            if (!hit_enemy(world, e, b.damage))
+                continue;
+            if (b.piercing)
+            {
+                b.damage = (int)std::lround(b.damage * b.falloff);
+                if (b.pierce_left == 0 || --b.pierce_left > 0)
+                    continue;
+            }
+            // Spent: park it at the impact point, where its sparks appear
+            b.active = false;
+            b.x = ox + ux * h.t;
+            b.y = oy + uy * h.t;
+            break;
+        }
+        if (blocked && b.active)
+        {
+            b.active = false;
+            b.x = ox + ux * wall;
+            b.y = oy + uy * wall;
+        }
+    }
+}
+
+// Push on agent `e` away from `o` when they are closer than the crowd
+// spacing: the unit direction scaled by how deep the overlap is (0..1)
+static void add_repulsion(const CrowdGrid::Agent &e, const CrowdGrid::Agent &o, double &px, double &py)
+{
+    double want = crowd_spacing * (e.width + o.width) / 2;
+    double dx = e.x - o.x, dy = e.y - o.y;
+    if (dx * dx + dy * dy >= want * want)
+        return;
+    double dist = std::sqrt(dx * dx + dy * dy);
+    if (dist == 0)
+    {
+        // Exactly stacked: split them sideways by enemy order
+        dx = e.enemy < o.enemy ? -1 : 1;
+        dy = 0;
+        dist = 1;
+    }
+    double overlap = (want - dist) / want;
+    px += dx / dist * overlap;
+    py += dy / dist * overlap;
+}
+
+// Crowd separation: every chaser (gathered into world.crowd during the enemy
+// updates) is pushed away from the neighbours it overlaps, so enemies
+// converging on the player spread into a crowd instead of stacking. Small
+// groups check every pair; larger ones are bucketed into the crowd grid and
+// each enemy looks at a bounded number of neighbours, so the pass stays
+// linear in the enemy count. Pushes are computed from the positions after
+// this tick's moves and applied together.
+static void separate_enemies(GameWorld &world)
+{
+    const int n = (int)world.crowd.size();
+    if (n < 2)
+        return;
+    std::vector<double> &push = world.pushes;
+    push.assign(2 * n, 0.0);
+
+    const bool use_grid = n > crowd_small;
+    if (use_grid)
+        world.crowd_grid.build(world.crowd, world.arena_w, world.arena_h);
+    const std::vector<CrowdGrid::Agent> &list = use_grid ? world.crowd_grid.agents() : world.crowd;
+    if (use_grid)
+    {
+        for (int a = 0; a < n; ++a)
+        {
+            const CrowdGrid::Agent &e = list[a];
+            world.crowd_grid.nearby(e.x, e.y, crowd_spacing * e.width * 1.25, crowd_neighbours + 1, world.neighbours);
+            for (int b : world.neighbours)
+                if (b != a)
+                    add_repulsion(e, list[b], push[2 * a], push[2 * a + 1]);
+        }
+    }
+    else
+    {
+        // Every pair once; the push on b mirrors the push on a
+        for (int a = 0; a < n; ++a)
+            for (int b = a + 1; b < n; ++b)
+            {
+                double px = 0, py = 0;
+                add_repulsion(list[a], list[b], px, py);
+                push[2 * a] += px;
+                push[2 * a + 1] += py;
+                push[2 * b] -= px;
+                push[2 * b + 1] -= py;
+            }
+    }
+
+    for (int a = 0; a < n; ++a)
+    {
+        double px = push[2 * a], py = push[2 * a + 1];
+        double len = std::sqrt(px * px + py * py);
+        if (len == 0)
+            continue;
+        double scale = crowd_max_push / std::max(len, 1.0);
+        EnemyBase &e = *world.enemies[list[a].enemy];
+        double ox = e.x, oy = e.y;
+        e.x += px * scale;
+        e.y += py * scale;
+        world.obstacles->settle(ox, oy, e.x, e.y, e.width, e.height);
+    }
+}
+
+// Hand the world's obstacles to the flow field the first time it steers for
+// this map (a fresh world, or one given another map). Chasers steer by their
+// top-left corner, so each obstacle is grown up and left by a chaser's size:
+// a path for the corner then keeps the whole box clear.
+static void sync_flow_obstacles(GameWorld &world)
+{
+    if (world.flow_obstacles == world.obstacles)
+        return;
+    world.flow.clear_obstacles();
+    for (const Obstacle &o : world.obstacles->obstacles())
+        world.flow.add_obstacle(o.x - flow_clearance, o.y - flow_clearance, o.w + flow_clearance,
+                                o.h + flow_clearance);
+    world.flow_obstacles = world.obstacles;
+}
+
+// Aim assist: move the aim onto the hurtbox centre of the enemy nearest the player
+// within a narrow cone around the aim line (an unchanged aim when none is)
+static void assist_aim(GameWorld &world, InputState &in)
+{
+    const player_data &player = world.player;
+    TargetQuery q;
+    q.x = player.player_x + player.player_width / 2;
+    q.y = player.player_y + player.player_hight / 2;
+    double ax = in.aim_x - q.x, ay = in.aim_y - q.y;
+    double len = std::sqrt(ax * ax + ay * ay);
+    if (len == 0)
+        return;
+    q.radius = assist_range;
+    q.ux = ax / len;
+    q.uy = ay / len;
+    q.min_cos = std::cos(assist_cone_deg * 3.141592654 / 180.0);
+
+    world.enemy_index.refresh(world.enemies, world.arena_w, world.arena_h);
+    int i = world.enemy_index.nearest(q);
+    if (i < 0 || !world.enemies[i]->alive)
+        return;
+    const HitRect target = world.enemies[i]->hurtbox();
+    in.aim_x = target.x + target.w / 2;
+    in.aim_y = target.y + target.h / 2;
+}
+
+void update_world(GameWorld &world, const InputState &in)
+{
+    player_data &player = world.player;
+
+    // Update blocking inside player module
+    update_player_block(player, in);
+
+    // Movement modifiers come from the held weapon (e.g. the Gatling)
+    int active_idx = active_weapon_index(world);
+    const WeaponInfo *held = active_idx != -1 ? &weapon_info(world.weapons[active_idx]->type_id()) : nullptr;
+    if (!player.blocking)
+    {
+        player.dash_disabled = held && held->no_dash;
+        player.player_speed = held ? held->move_speed : 2.0;
+        double ox = player.player_x, oy = player.player_y;
+        update_player(player, in, world.arena_w, world.arena_h);
+        world.obstacles->settle(ox, oy, player.player_x, player.player_y, player.player_width, player.player_hight);
+    }
+
+    silence_weapons(world, active_idx);
+    world.enemy_index.invalidate();
+    if (active_idx != -1)
+    {
+        WeaponBase &weapon = *world.weapons[active_idx];
+        InputState aimed = in;
+        if (in.aim_assist)
+            assist_aim(world, aimed);
+        weapon.update(world, aimed);
+        resolve_bullet_hits(world, weapon.bullets());
+        const ViewRect active = active_region(world);
+        sync_flow_obstacles(world);
+        world.flow.update(player.player_x, player.player_y, active.x, active.y, active.w, active.h);
+        world.crowd.clear();
+
+        // Dead enemies do nothing, so they are dropped here (keeping order)
+        // instead of piling up for the rest of the wave. A dead boss stays:
+        // its death plays out over later ticks. Obstacles stop every enemy
+        // but the boss, which checks them in the states where it walks.
+        int kept = 0;
+        for (int i = 0; i < (int)world.enemies.size(); ++i)
+        {
+            EnemyBase &e = *world.enemies[i];
+            double ox = e.x, oy = e.y;
+            e.update(world);
+            if (e.kind() != EnemyKind::Boss)
+                world.obstacles->settle(ox, oy, e.x, e.y, e.width, e.height);
+            if (!e.alive && e.kind() != EnemyKind::Boss)
+                continue;
+            if (e.alive && e.kind() != EnemyKind::Boss)
+                world.crowd.push_back({e.x + e.width / 2, e.y + e.height / 2, e.width, kept});
+            if (kept != i)
+                world.enemies[kept] = std::move(world.enemies[i]);
+            ++kept;
+        }
+        world.enemies.resize(kept);
+        separate_enemies(world);
+    }
+
+    // Invulnerability after a hit runs out once per tick, however many enemies
+    if (player.damage_cooldown > 0)
+        player.damage_cooldown--;
+
+    if (world.wave_in_progress)
+    {
+        spawn_enemies(world);
+    }
+    // When not in progress, wait for Enter (no auto start)
+}
+
+void update_coins(GameWorld &world)
+{
+    const player_data &player = world.player;
+
+    // Spin every coin in one pass (collected slots too: they restart on reuse)
+    coin_clip().step_all(world.coins.begin(), world.coins.end(), &Coin::anim);
+
+    for (int i = 0; i < (int)world.coins.size(); ++i)
+    {
+        Coin &c = world.coins[i];
+        if (!c.active)
+            continue;
+        double dx = player.player_x - c.x;
+        double dy = player.player_y - c.y;
+        double dist = sqrt(dx * dx + dy * dy);
+        if (dist > 1)
+        {
+            double suck_speed = 10.0; // slower coin speed
+            c.x += (dx / dist) * suck_speed;
+            c.y += (dy / dist) * suck_speed;
+        }
+        if (dist < 75)
+        {
+            world.money += (int)c.value;
+            c.active = false;
+            world.free_coins.push_back(i);
+            std::push_heap(world.free_coins.begin(), world.free_coins.end(), std::greater<int>());
+        }
+    }
+}
@@ -0,0 +1,145 @@
+// GameWorld: all mutable state of one running game, passed explicitly to the
+// systems that need it. Nothing in the simulation lives in globals or
+// file-statics, so several worlds can exist side by side.
+#pragma once
+#include "../player/player.hpp"
+#include "../weapon/weapon_base.hpp"
+#include "../enemy/enemy_base.hpp"
+#include "../enemy/wave_schedule.hpp"
+#include "../coin.hpp"
+#include "input.hpp"
+#include "enemy_index.hpp"
+#include "camera.hpp"
+#include "crowd_grid.hpp"
+#include "flow_field.hpp"
+#include "obstacle_map.hpp"
+#include "rng.hpp"
+#include "sound_event.hpp"
+#include <memory>
+#include <vector>
+
+// Wave spawn tracking (exposed for HUD)
+struct SpawnState
+{
+    int timer = 0;             // Frames since last spawn attempt
+    int last_wave = -1;        // Wave the counters below belong to
+    int cursor = 0;            // Next event in the wave's spawn timeline
+    int spawned_this_wave = 0; // Enemies spawned so far this wave
+    int max_in_this_wave = 0;  // Enemies this wave will spawn in total
+    int alive = 0;             // Alive enemies (kept by spawn_enemies and hit_enemy)
+};
+
+struct GameWorld
+{
+    player_data player;                                // The player
+    int money = 0;                                     // Player's total money
+    std::vector<Coin> coins;                           // Coin slots (inactive ones are reused)
+    std::vector<int> free_coins;                       // Inactive slots in `coins` (min-heap, derived)
+    std::vector<std::unique_ptr<EnemyBase>> enemies;   // Live and dead enemies of this wave
+    std::vector<std::unique_ptr<WeaponBase>> weapons;  // Two weapon slots
+    int current_weapon = 0;                            // Active weapon slot
+
+    int wave = 1;                     // Current wave number
+    bool wave_in_progress = true;     // Whether current wave is active
+    int wave_clear_timer = 0;         // Timer for wave-clear delay
+    bool wave_cleared_prompt = false; // Waiting for Enter to start the next wave
+    bool endless = false;             // Endless mode: generated waves, no boss, no last wave
+    SpawnState spawn;                 // Spawner counters
+
+    int camera_shake_timer = 0; // Screen shake timer
+    int kill_marker_timer = 0;  // Kill hitmarker timer
+    int block_flash_timer = 0;  // Block yellow flash timer
+
+    int arena_w = 3200; // Play area size (larger than the view, which scrolls)
+    int arena_h = 2400;
+    int view_w = 1600;  // Screen-sized view that follows the player
+    int view_h = 1200;
+    const ObstacleMap *obstacles = &arena_obstacles(); // Walls and crates (shared, never null)
+
+    EnemyIndex enemy_index;       // Live enemy boxes at the start of the tick (derived, not saved)
+    std::vector<RayHit> ray_hits; // Scratch for bullet sweeps
+    FlowField flow;               // Chasers' directions toward the player (derived, not saved)
+    const ObstacleMap *flow_obstacles = nullptr; // Obstacle map `flow` was given (derived)
+    CrowdGrid crowd_grid;         // Enemy centres for crowd separation (derived, not saved)
+    std::vector<CrowdGrid::Agent> crowd; // Scratch for crowd separation: enemies taking part
+    std::vector<int> neighbours;  // Scratch for crowd separation: one enemy's candidates
+    std::vector<double> pushes;   // Scratch for crowd separation: x, y per agent
+    WaveInfo endless_wave;        // Timeline of endless wave `endless_built` (derived, not saved)
+    int endless_built = 0;
+
+    Rng rng;               // Gameplay randomness (spawns, drops, boss moves)
+    bool headless = false; // No bitmaps, audio or VFX: batch/training runs
+    std::vector<bitmap> coin_frames; // Shared coin animation (empty when headless)
+    std::vector<SoundEvent> sounds;  // Sound requests not yet handed to the window thread (see audio.hpp)
+};
+
+// Forget spawner progress (next spawn_enemies call starts the wave fresh).
+// Also zeroes the alive count: call it together with clearing the enemies.
+inline void reset_spawn_state(SpawnState &s)
+{
+    s.timer = 0;
+    s.last_wave = -1;
+    s.cursor = 0;
+    s.spawned_this_wave = 0;
+    s.max_in_this_wave = 0;
+    s.alive = 0;
+}
+
+// Simulation past the view: how far beyond it enemies are steered by the
+// flow field and bullets stay live
+const double kActiveMargin = 384;
+
+// The view following the player (without camera shake)
+inline ViewRect camera_view(const GameWorld &world)
+{
+    const player_data &p = world.player;
+    return follow_camera(p.player_x + p.player_width / 2.0, p.player_y + p.player_hight / 2.0, world.view_w,
+                         world.view_h, world.arena_w, world.arena_h);
+}
+
+// The part of the arena the simulation spends effort on: the view plus
+// kActiveMargin. Enemies outside it still move, straight at the player.
+inline ViewRect active_region(const GameWorld &world) { return camera_view(world).grown(kActiveMargin); }
+
+// Clearing this wave ends the run / this wave has a boss (never in endless mode)
+inline bool final_wave(const GameWorld &world) { return !world.endless && is_final_wave(world.wave); }
+inline bool boss_wave(const GameWorld &world) { return !world.endless && wave_has_boss(world.wave); }
+
+// Land one player hit on `e` (see EnemyBase::take_hit), keeping the alive
+// count in step; false when `e` is already dead or the hit does not land
+inline bool hit_enemy(GameWorld &world, EnemyBase &e, int damage)
+{
+    if (!e.alive || !e.take_hit(world, damage))
+        return false;
+    if (!e.alive)
+        world.spawn.alive--;
+    return true;
+}
+
+// Load bitmaps shared by world objects and every enemy kind's sprites (skip
+// for headless worlds)
+void load_world_assets(GameWorld &world);
+
+// Fresh run: wave 1, default loadout, full hearts, player centred
+void start_new_game(GameWorld &world, bool endless = false);
+
+// Advance from the wave-cleared intermission into the next wave
+void begin_next_wave(GameWorld &world);
+
+// Drop a coin worth `value` at (x, y)
+void spawn_coin(GameWorld &world, double x, double y, double value);
+
+// The coin spin, shared by every coin (frames index GameWorld::coin_frames)
+const AnimClip &coin_clip();
+
+// Active weapon slot with fallback to any filled slot; -1 when unarmed
+int active_weapon_index(GameWorld &world);
+
+// Stop looping weapon sounds in every slot but `except` (-1: all)
+void silence_weapons(GameWorld &world, int except = -1);
+
+// One gameplay tick: blocking, movement, weapon, enemies, spawning
+void update_world(GameWorld &world, const InputState &in);
+
+// Coin animation and attraction towards the player
+void update_coins(GameWorld &world);
@@ -0,0 +1,61 @@
+// Per-frame input sample: the only place gameplay code reads the keyboard/mouse.
+#pragma once
+#include "splashkit.h"
+
+// Snapshot of the controls the simulation cares about for one tick
+struct InputState
+{
+    bool move_up = false;       // W held
+    bool move_down = false;     // S held
+    bool move_left = false;     // A held
+    bool move_right = false;    // D held
+    bool dash_pressed = false;  // Left Shift typed this frame
+    bool block_pressed = false; // Space typed this frame
+    bool fire_down = false;     // Left mouse held
+    bool fire_clicked = false;  // Left mouse clicked this frame
+    double aim_x = 0;           // Crosshair position (arena coordinates)
+    double aim_y = 0;
+    bool aim_assist = false;    // Setting: shots go to the enemy nearest the aim line
+    double mouse_x = 0;         // Mouse in screen coordinates (shop)
+    double mouse_y = 0;
+    bool close_typed = false;   // Escape, Space or Enter typed this frame (closes the shop)
+
+    bool moving() const { return move_up || move_down || move_left || move_right; }
+
+    // Keep the typed/clicked edges of `older`, a sample no tick has seen yet
+    void merge_edges(const InputState &older)
+    {
+        dash_pressed |= older.dash_pressed;
+        block_pressed |= older.block_pressed;
+        fire_clicked |= older.fire_clicked;
+        close_typed |= older.close_typed;
+    }
+
+    // Forget the edges once a tick has seen them
+    void clear_edges()
+    {
+        dash_pressed = block_pressed = fire_clicked = close_typed = false;
+    }
+};
+
+// Read SplashKit's event state once, after process_events(); (view_x,
+// view_y) is the top-left of the view the player sees, to turn the mouse into
+// arena coordinates
+inline InputState sample_input(double view_x = 0, double view_y = 0)
+{
+    InputState in;
+    in.move_up = key_down(W_KEY);
+    in.move_down = key_down(S_KEY);
+    in.move_left = key_down(A_KEY);
+    in.move_right = key_down(D_KEY);
+    in.dash_pressed = key_typed(LEFT_SHIFT_KEY);
+    in.block_pressed = key_typed(SPACE_KEY);
+    in.fire_down = mouse_down(LEFT_BUTTON);
+    in.fire_clicked = mouse_clicked(LEFT_BUTTON);
+    in.mouse_x = mouse_x();
+    in.mouse_y = mouse_y();
+    in.aim_x = in.mouse_x + view_x;
+    in.aim_y = in.mouse_y + view_y;
+    in.close_typed = key_typed(ESCAPE_KEY) || key_typed(SPACE_KEY) || key_typed(RETURN_KEY);
+    return in;
+}
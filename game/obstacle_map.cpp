@@ -0,0 +1,197 @@
+// Static obstacles: obstacles.def parser, grid bake and queries.
+#include "obstacle_map.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    const double kInf = std::numeric_limits<double>::infinity();
+
+    struct Layout
+    {
+        ObstacleMap map;
+        std::string error;
+    };
+
+    bool fail(Layout &layout, int line, const std::string &msg)
+    {
+        layout.error = std::string(kObstacleDefsPath) + ":" + std::to_string(line) + ": " + msg;
+        layout.map.bake({});
+        return false;
+    }
+
+    bool on_grid(double v) { return v >= 0 && std::fmod(v, ObstacleMap::kCell) == 0; }
+
+    bool load(Layout &layout, const char *path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+            return fail(layout, 0, "cannot open");
+
+        std::vector<Obstacle> list;
+        std::string raw;
+        for (int line = 1; std::getline(file, raw); ++line)
+        {
+            std::istringstream in(raw.substr(0, raw.find('#')));
+            std::string key;
+            if (!(in >> key))
+                continue;
+
+            Obstacle o;
+            if (key == "wall") o.kind = ObstacleKind::Wall;
+            else if (key == "crate") o.kind = ObstacleKind::Crate;
+            else return fail(layout, line, "bad line '" + key + "'");
+            if (!(in >> o.x >> o.y >> o.w >> o.h) || !on_grid(o.x) || !on_grid(o.y) || !on_grid(o.w) ||
+                !on_grid(o.h) || o.w == 0 || o.h == 0)
+                return fail(layout, line, key + " needs <x> <y> <w> <h> on the " + std::to_string(ObstacleMap::kCell) +
+                                              " px grid, with a positive size");
+            list.push_back(o);
+        }
+        layout.map.bake(list);
+        return true;
+    }
+
+    // Parsed and baked on first use (thread-safe), never reloaded
+    const Layout &layout()
+    {
+        static const Layout l = [] {
+            Layout r;
+            load(r, kObstacleDefsPath);
+            return r;
+        }();
+        return l;
+    }
+}
+
+void ObstacleMap::bake(const std::vector<Obstacle> &obstacles)
+{
+    obstacles_ = obstacles;
+    cols_ = rows_ = 0;
+    for (const Obstacle &o : obstacles_)
+    {
+        cols_ = std::max(cols_, (int)std::ceil((o.x + o.w) / kCell));
+        rows_ = std::max(rows_, (int)std::ceil((o.y + o.h) / kCell));
+    }
+    words_ = (cols_ + 63) / 64;
+    bits_.assign((size_t)words_ * rows_, 0);
+    for (const Obstacle &o : obstacles_)
+    {
+        const int c0 = (int)std::floor(o.x / kCell), c1 = (int)std::ceil((o.x + o.w) / kCell) - 1;
+        const int r0 = (int)std::floor(o.y / kCell), r1 = (int)std::ceil((o.y + o.h) / kCell) - 1;
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c)
+                bits_[(size_t)r * words_ + c / 64] |= uint64_t(1) << (c % 64);
+    }
+}
+
+bool ObstacleMap::cell(int c, int r) const
+{
+    if (c < 0 || c >= cols_ || r < 0 || r >= rows_)
+        return false;
+    return (bits_[(size_t)r * words_ + c / 64] >> (c % 64)) & 1;
+}
+
+// Any occupied cell in columns c0..c1 of rows r0..r1 (inclusive); each row is
+// tested a word at a time, the end words masked to the range
+bool ObstacleMap::any_in(int c0, int r0, int c1, int r1) const
+{
+    c0 = std::max(c0, 0);
+    r0 = std::max(r0, 0);
+    c1 = std::min(c1, cols_ - 1);
+    r1 = std::min(r1, rows_ - 1);
+    if (c0 > c1 || r0 > r1)
+        return false;
+    const int w0 = c0 / 64, w1 = c1 / 64;
+    const uint64_t first = ~uint64_t(0) << (c0 % 64);
+    const uint64_t last = ~uint64_t(0) >> (63 - c1 % 64);
+    for (int r = r0; r <= r1; ++r)
+    {
+        const uint64_t *row = &bits_[(size_t)r * words_];
+        for (int w = w0; w <= w1; ++w)
+        {
+            uint64_t mask = ~uint64_t(0);
+            if (w == w0) mask &= first;
+            if (w == w1) mask &= last;
+            if (row[w] & mask)
+                return true;
+        }
+    }
+    return false;
+}
+
+bool ObstacleMap::solid(double x, double y) const
+{
+    return cell((int)std::floor(x / kCell), (int)std::floor(y / kCell));
+}
+
+bool ObstacleMap::overlaps(double x, double y, double w, double h) const
+{
+    return any_in((int)std::floor(x / kCell), (int)std::floor(y / kCell), (int)std::ceil((x + w) / kCell) - 1,
+                  (int)std::ceil((y + h) / kCell) - 1);
+}
+
+bool ObstacleMap::raycast(double x, double y, double ux, double uy, double max_t, double &t) const
+{
+    // Cells under the segment's bounds first: usually there are none
+    const double x1 = x + ux * max_t, y1 = y + uy * max_t;
+    if (!any_in((int)std::floor(std::min(x, x1) / kCell), (int)std::floor(std::min(y, y1) / kCell),
+                (int)std::floor(std::max(x, x1) / kCell), (int)std::floor(std::max(y, y1) / kCell)))
+        return false;
+
+    // Grid DDA. A start on a cell edge belongs to the cell the ray heads into.
+    int c = ux < 0 ? (int)std::ceil(x / kCell) - 1 : (int)std::floor(x / kCell);
+    int r = uy < 0 ? (int)std::ceil(y / kCell) - 1 : (int)std::floor(y / kCell);
+    const int sc = ux > 0 ? 1 : -1, sr = uy > 0 ? 1 : -1;
+    const double step_x = ux != 0 ? kCell / std::fabs(ux) : kInf;
+    const double step_y = uy != 0 ? kCell / std::fabs(uy) : kInf;
+    double next_x = ux != 0 ? ((c + (ux > 0)) * kCell - x) / ux : kInf;
+    double next_y = uy != 0 ? ((r + (uy > 0)) * kCell - y) / uy : kInf;
+    double at = 0;
+    while (at <= max_t)
+    {
+        if (cell(c, r))
+        {
+            t = at;
+            return true;
+        }
+        // Heading away from the grid: nothing more to hit
+        if ((c < 0 && sc < 0) || (c >= cols_ && sc > 0) || (r < 0 && sr < 0) || (r >= rows_ && sr > 0))
+            return false;
+        if (next_x < next_y)
+        {
+            at = next_x;
+            next_x += step_x;
+            c += sc;
+        }
+        else
+        {
+            at = next_y;
+            next_y += step_y;
+            r += sr;
+        }
+    }
+    return false;
+}
+
+void ObstacleMap::settle(double ox, double oy, double &x, double &y, double w, double h) const
+{
+    if (!overlaps(x, y, w, h) || overlaps(ox, oy, w, h))
+        return;
+    if (overlaps(x, oy, w, h))
+        x = ox;
+    if (overlaps(x, y, w, h))
+        y = oy;
+}
+
+const ObstacleMap &arena_obstacles()
+{
+    return layout().map;
+}
+
+const std::string &obstacle_defs_error()
+{
+    return layout().error;
+}
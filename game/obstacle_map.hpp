@@ -0,0 +1,73 @@
+// Static obstacles: the walls and crates of the arena, read once from
+// game/obstacles.def and baked into an occupancy grid of 16 px cells, one bit
+// per cell, packed 64 to a word along each row. Obstacles are snapped to the
+// grid, so the grid is exact, not an approximation of the boxes.
+//
+// Every query reads only the words under the region it asks about: a box test
+// is a few masked words per row, and a ray walks the cells it crosses (grid
+// DDA) after a box test of its bounds, which answers most short bullet
+// segments in open ground. Nothing is allocated after the bake, and the map
+// is never written again, so worlds share it.
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const char *const kObstacleDefsPath = "game/obstacles.def";
+
+enum class ObstacleKind : uint8_t
+{
+    Wall,
+    Crate
+};
+
+// One obstacle as laid out in the file (arena coordinates)
+struct Obstacle
+{
+    ObstacleKind kind = ObstacleKind::Wall;
+    double x = 0, y = 0, w = 0, h = 0;
+};
+
+class ObstacleMap
+{
+public:
+    static const int kCell = 16; // Cell size in pixels; obstacles snap to it
+
+    // Rasterise `obstacles` (replacing any earlier bake)
+    void bake(const std::vector<Obstacle> &obstacles);
+
+    const std::vector<Obstacle> &obstacles() const { return obstacles_; }
+    bool empty() const { return obstacles_.empty(); }
+
+    // Whether the point (x, y) lies inside an obstacle
+    bool solid(double x, double y) const;
+
+    // Whether the box (x, y, w, h) overlaps an obstacle (touching edges do not)
+    bool overlaps(double x, double y, double w, double h) const;
+
+    // Whether the ray from (x, y) along the unit vector (ux, uy) enters an
+    // obstacle within max_t; on a hit `t` is the entry distance (0 when the
+    // ray starts inside one)
+    bool raycast(double x, double y, double ux, double uy, double max_t, double &t) const;
+
+    // A box of size w x h has moved from (ox, oy) to (x, y): drop each axis of
+    // the move that would take it into an obstacle, so it slides along walls.
+    // A box that was already inside one (spawned or pushed there) may move
+    // freely until it is out.
+    void settle(double ox, double oy, double &x, double &y, double w, double h) const;
+
+private:
+    std::vector<Obstacle> obstacles_;
+    int cols_ = 0, rows_ = 0; // Grid from the arena origin to the farthest obstacle
+    int words_ = 0;           // 64-bit words per row
+    std::vector<uint64_t> bits_;
+
+    bool cell(int c, int r) const;
+    bool any_in(int c0, int r0, int c1, int r1) const;
+};
+
+// The layout from obstacles.def, baked on first use (empty if the file failed)
+const ObstacleMap &arena_obstacles();
+
+// Empty when obstacles.def loaded, else "file:line: message"
+const std::string &obstacle_defs_error();
@@ -0,0 +1,179 @@
+// Rewind ring buffer with delta-compressed history.
+#include "rewind.hpp"
+#include <cstring>
+
+namespace
+{
+    void put_varint(std::vector<uint8_t> &out, size_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back((uint8_t)v);
+    }
+
+    size_t get_varint(const uint8_t *&p)
+    {
+        size_t v = 0;
+        for (int shift = 0;; shift += 7)
+        {
+            uint8_t b = *p++;
+            v |= (size_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+    }
+
+    bool same(const std::vector<uint8_t> &base, const std::vector<uint8_t> &target, size_t i)
+    {
+        return i < base.size() && base[i] == target[i];
+    }
+
+    // Delta layout: varint target size, then (varint skip, varint literal
+    // length, literal bytes) until the target is covered. Skipped bytes are
+    // copied from the base at the same offset.
+    void encode_delta(const std::vector<uint8_t> &base, const std::vector<uint8_t> &target, std::vector<uint8_t> &out)
+    {
+        const size_t n = target.size();
+        const size_t min_skip = 4; // shorter matches cost more to encode than to copy
+        out.clear();
+        put_varint(out, n);
+        size_t i = 0;
+        while (i < n)
+        {
+            size_t skip_start = i;
+            while (i < n && same(base, target, i)) ++i;
+            size_t lit_start = i;
+            while (i < n)
+            {
+                size_t run = 0;
+                while (run < min_skip && i + run < n && same(base, target, i + run)) ++run;
+                if (run == min_skip || i + run == n) break;
+                i += run + 1;
+            }
+            put_varint(out, lit_start - skip_start);
+            put_varint(out, i - lit_start);
+            out.insert(out.end(), target.begin() + lit_start, target.begin() + i);
+        }
+    }
+
+    void apply_delta(const std::vector<uint8_t> &base, const std::vector<uint8_t> &delta, std::vector<uint8_t> &out)
+    {
+        const uint8_t *p = delta.data();
+        size_t n = get_varint(p);
+        out.resize(n);
+        size_t i = 0;
+        while (i < n)
+        {
+            size_t skip = get_varint(p);
+            size_t lit = get_varint(p);
+            std::memcpy(out.data() + i, base.data() + i, skip);
+            i += skip;
+            std::memcpy(out.data() + i, p, lit);
+            p += lit;
+            i += lit;
+        }
+    }
+}
+
+RewindBuffer::RewindBuffer(RewindConfig cfg) : cfg_(cfg)
+{
+    if (cfg_.interval < 1) cfg_.interval = 1;
+    if (cfg_.capacity < 1) cfg_.capacity = 1;
+    ring_.resize(cfg_.capacity);
+}
+
+void RewindBuffer::clear()
+{
+    tick_ = 0;
+    head_.clear();
+    head_tick_ = 0;
+    first_ = 0;
+    count_ = 0;
+    delta_bytes_ = 0;
+}
+
+void RewindBuffer::tick(const GameWorld &world)
+{
+    if (tick_ % cfg_.interval == 0)
+        capture(world);
+    ++tick_;
+}
+
+void RewindBuffer::checkpoint(const GameWorld &world)
+{
+    checkpoint_.clear();
+    ByteWriter w(checkpoint_);
+    write_world(w, world);
+    clear();
+}
+
+void RewindBuffer::capture(const GameWorld &world)
+{
+    scratch_.clear();
+    ByteWriter w(scratch_);
+    write_world(w, world);
+
+    if (!head_.empty())
+    {
+        if (count_ == (int)ring_.size())
+            drop_oldest();
+        Entry &e = entry(count_);
+        e.tick = head_tick_;
+        encode_delta(scratch_, head_, e.delta);
+        delta_bytes_ += e.delta.size();
+        ++count_;
+        while (delta_bytes_ > cfg_.max_bytes && count_ > 0)
+            drop_oldest();
+    }
+
+    head_.swap(scratch_);
+    head_tick_ = tick_;
+}
+
+void RewindBuffer::drop_oldest()
+{
+    delta_bytes_ -= entry(0).delta.size();
+    first_ = (first_ + 1) % (int)ring_.size();
+    --count_;
+}
+
+bool RewindBuffer::rewind(GameWorld &world, long ticks_back)
+{
+    if (head_.empty())
+        return false;
+
+    // Walk back from the newest snapshot, consuming history as we go
+    long target = tick_ - ticks_back;
+    while (head_tick_ > target && count_ > 0)
+    {
+        Entry &e = entry(count_ - 1);
+        apply_delta(head_, e.delta, work_);
+        head_.swap(work_);
+        head_tick_ = e.tick;
+        delta_bytes_ -= e.delta.size();
+        --count_;
+    }
+
+    ByteReader r(head_);
+    if (!read_world(r, world))
+        return false;
+    tick_ = head_tick_ + 1; // head_ stays as the snapshot for this tick
+    return true;
+}
+
+bool RewindBuffer::retry(GameWorld &world)
+{
+    if (checkpoint_.empty())
+        return false;
+    ByteReader r(checkpoint_);
+    bool ok = read_world(r, world);
+    clear();
+    return ok;
+}
+
+size_t RewindBuffer::bytes_used() const
+{
+    return head_.size() + delta_bytes_ + checkpoint_.size();
+}
@@ -0,0 +1,69 @@
+// Rewind buffer: world snapshots taken every few ticks and kept in a bounded
+// ring, so a death can be undone by restoring a recent snapshot (rewind) or
+// the snapshot taken when the wave started (retry).
+//
+// Only the newest snapshot is stored in full. Each older one is kept as a
+// delta against the next newer snapshot (runs of unchanged bytes are skipped),
+// so stepping back is a chain of byte patches and the oldest entry can be
+// dropped on its own. Restoring goes through read_world, which updates
+// existing enemies and weapons in place: no entity allocation, no assets.
+#pragma once
+#include "snapshot.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct RewindConfig
+{
+    int interval = 30;                 // Ticks between snapshots (0.25 s at 120 fps)
+    int capacity = 64;                 // Older snapshots kept (16 s of history at the default interval)
+    size_t max_bytes = 4 * 1024 * 1024; // Cap on the stored deltas; oldest are dropped first
+};
+
+class RewindBuffer
+{
+public:
+    explicit RewindBuffer(RewindConfig cfg = RewindConfig());
+
+    // Forget all history (the wave-start checkpoint is kept)
+    void clear();
+
+    // Call once per simulated tick; captures a snapshot every cfg.interval ticks
+    void tick(const GameWorld &world);
+
+    // Store the wave-start snapshot used by retry() and restart the history
+    void checkpoint(const GameWorld &world);
+
+    // Restore the newest snapshot that is at least `ticks_back` ticks old (or
+    // the oldest one kept). Newer history is discarded. False when empty.
+    bool rewind(GameWorld &world, long ticks_back);
+
+    // Restore the wave-start checkpoint. False when none was taken.
+    bool retry(GameWorld &world);
+
+    int size() const { return count_ + (head_.empty() ? 0 : 1); } // Snapshots available
+    size_t bytes_used() const;                                      // Snapshot + delta storage
+
+private:
+    struct Entry
+    {
+        long tick = 0;              // Tick the snapshot was taken at
+        std::vector<uint8_t> delta; // Turns the next newer snapshot into this one
+    };
+
+    RewindConfig cfg_;
+    long tick_ = 0;                  // Ticks seen since the last clear
+    std::vector<uint8_t> head_;      // Newest snapshot, in full
+    long head_tick_ = 0;
+    std::vector<Entry> ring_;        // Older snapshots, oldest at first_
+    int first_ = 0;
+    int count_ = 0;
+    size_t delta_bytes_ = 0;
+    std::vector<uint8_t> checkpoint_; // Wave-start snapshot for retry
+    std::vector<uint8_t> scratch_;    // Reused encode/decode buffers
+    std::vector<uint8_t> work_;
+
+    void capture(const GameWorld &world);
+    void drop_oldest();
+    Entry &entry(int i) { return ring_[(first_ + i) % ring_.size()]; }
+};
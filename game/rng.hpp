@@ -0,0 +1,39 @@
+// Small deterministic RNG owned by each GameWorld (xorshift64*), so a seed
+// fully determines a run and worlds on different threads never share state.
+#pragma once
+#include <cstdint>
+
+struct Rng
+{
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    void seed(uint64_t s)
+    {
+        // splitmix64 scramble so nearby seeds give unrelated streams
+        s += 0x9E3779B97F4A7C15ull;
+        s = (s ^ (s >> 30)) * 0xBF58476D1CE4E5B9ull;
+        s = (s ^ (s >> 27)) * 0x94D049BB133111EBull;
+        state = (s ^ (s >> 31)) | 1;
+    }
+
+    uint32_t next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<uint32_t>((state * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+
+    // 0..n-1 (0 when n <= 0), same contract as SplashKit's rnd(n)
+    int below(int n) { return n > 0 ? static_cast<int>(next() % static_cast<uint32_t>(n)) : 0; }
+
+    // min..max inclusive, same contract as SplashKit's rnd(min, max)
+    int range(int min_val, int max_val)
+    {
+        if (max_val <= min_val) return min_val;
+        return min_val + below(max_val - min_val + 1);
+    }
+
+    // [0, 1)
+    double unit() { return next() * (1.0 / 4294967296.0); }
+};
@@ -0,0 +1,58 @@
+/* C interface to the headless training environment (see env.hpp).
+ * Plain C so it can be loaded with ctypes/cffi. All buffers are owned by
+ * the caller; no call allocates after create/reset. */
+#ifndef SHOOTER_ENV_H
+#define SHOOTER_ENV_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Observation layout (floats):
+ *   player       8: x, y (0..1 of arena), hearts/max, blocking, dashing,
+ *                   invulnerable, wave/wave count (waves.def), live enemies/10
+ *   enemies   8 x 5: dx, dy (arena-normalised, from player centre),
+ *                   hp/1000, telegraphing, present
+ *   projectiles 16 x 5: dx, dy (arena-normalised), vx/10, vy/10, present
+ * Enemies and projectiles are sorted nearest first; empty rows are zero. */
+#define SHOOTER_OBS_ENEMIES 8
+#define SHOOTER_OBS_PROJECTILES 16
+#define SHOOTER_OBS_SIZE (8 + SHOOTER_OBS_ENEMIES * 5 + SHOOTER_OBS_PROJECTILES * 5)
+
+typedef struct ShooterAction
+{
+    int8_t move_x;  /* -1 left, 0, 1 right */
+    int8_t move_y;  /* -1 up, 0, 1 down */
+    uint8_t fire;   /* hold trigger (semi-autos fire when off cooldown) */
+    uint8_t block;  /* start a block */
+    uint8_t dash;   /* dash in the move direction */
+    float aim_x;    /* aim direction relative to the player centre */
+    float aim_y;
+} ShooterAction;
+
+typedef struct ShooterEnv ShooterEnv;
+typedef struct ShooterVecEnv ShooterVecEnv;
+
+/* Single world */
+ShooterEnv *shooter_env_create(int frame_skip);
+void shooter_env_destroy(ShooterEnv *env);
+void shooter_env_reset(ShooterEnv *env, uint64_t seed, float *obs);
+/* Returns 1 when the episode ended (death, the final wave of waves.def cleared or step limit) */
+int shooter_env_step(ShooterEnv *env, const ShooterAction *action, float *obs, float *reward);
+
+/* N worlds stepped in lockstep by a persistent thread pool. Finished
+ * worlds reset themselves; obs then holds the first observation of the
+ * next episode and dones[i] is 1 for that step. */
+ShooterVecEnv *shooter_vec_create(int num_envs, int num_threads, int frame_skip, uint64_t seed);
+void shooter_vec_destroy(ShooterVecEnv *vec);
+void shooter_vec_reset(ShooterVecEnv *vec, float *obs);
+void shooter_vec_step(ShooterVecEnv *vec, const ShooterAction *actions,
+                      float *obs, float *rewards, uint8_t *dones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+// Simulation thread: the fixed-rate tick loop.
+#include "sim_thread.hpp"
+#include <utility>
+
+// Ticks the loop may fall behind before it drops the backlog (after a stall
+// it resumes at the normal rate instead of running the missed ticks back to
+// back)
+const int kMaxCatchUpTicks = 6;
+
+SimThread::SimThread(double hz, Tick tick)
+    : period_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / hz))),
+      tick_(std::move(tick)),
+      thread_(&SimThread::loop, this)
+{
+}
+
+SimThread::~SimThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void SimThread::set_input(const InputState &in)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    InputState merged = in;
+    merged.merge_edges(input_);
+    input_ = merged;
+}
+
+unsigned long SimThread::post(std::function<void()> command)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    queue_.push_back(std::move(command));
+    return ++posted_;
+}
+
+void SimThread::loop()
+{
+    using clock = std::chrono::steady_clock;
+    std::vector<std::function<void()>> commands;
+    clock::time_point next = clock::now();
+    for (;;)
+    {
+        InputState in;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (cv_.wait_until(lock, next, [&] { return quit_; }))
+                return;
+            commands.swap(queue_);
+            in = input_;
+            input_.clear_edges();
+        }
+
+        for (auto &command : commands)
+        {
+            command();
+            done_++;
+        }
+        commands.clear();
+        tick_(in, done_);
+
+        next += period_;
+        const clock::time_point now = clock::now();
+        if (now - next > kMaxCatchUpTicks * period_)
+            next = now;
+    }
+}
@@ -0,0 +1,54 @@
+// Simulation thread: runs the game's ticks at a fixed rate, independent of
+// the window thread's frame rate. The world belongs to this thread; the window
+// thread only hands it input and commands, and reads back the frame snapshots
+// the ticks publish.
+//
+// - Input goes through a latest-input slot: each tick sees the newest sample,
+//   and a key typed or a click between two ticks is kept until a tick saw it.
+// - Commands (menu, shop, save/load, retry, rewind...) run on this thread
+//   between two ticks, in the order they were posted. Each gets a serial, and
+//   every tick is told the serial of the last one run before it, so the
+//   snapshot it publishes can say which commands it already reflects.
+#pragma once
+#include "input.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class SimThread
+{
+public:
+    // One tick: `in` is the input sample, `commands` the serial of the last
+    // command run so far (0: none yet)
+    using Tick = std::function<void(const InputState &in, unsigned long commands)>;
+
+    // Start calling `tick` `hz` times a second
+    SimThread(double hz, Tick tick);
+    ~SimThread(); // Finishes the tick in flight, then stops (queued commands are dropped)
+
+    // Window thread: the newest input sample
+    void set_input(const InputState &in);
+
+    // Window thread: run `command` on the simulation thread before its next
+    // tick; returns the command's serial (1, 2, ...)
+    unsigned long post(std::function<void()> command);
+
+private:
+    void loop();
+
+    const std::chrono::steady_clock::duration period_;
+    Tick tick_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    InputState input_;                           // Latest sample, edges merged
+    std::vector<std::function<void()>> queue_;   // Posted, not run yet
+    unsigned long posted_ = 0;                   // Serial of the last command posted
+    bool quit_ = false;
+
+    unsigned long done_ = 0; // Simulation thread only
+    std::thread thread_;     // Last: starts once the fields above exist
+};
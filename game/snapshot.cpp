@@ -0,0 +1,145 @@
+// World snapshot serialisation.
+#include "snapshot.hpp"
+#include "game_world.hpp"
+#include "../enemy/enemy_spawn.hpp"
+#include "../weapon/weapon_registry.hpp"
+
+namespace
+{
+    const uint32_t kSnapshotMagic = 0x38485353; // "SSH8"; bump when a field list changes
+
+    template <class Stream, class Player>
+    void transfer_player(Stream &s, Player &p)
+    {
+        s.field(p.player_x); s.field(p.player_y); s.field(p.player_speed);
+        s.field(p.hearts); s.field(p.max_hearts); s.field(p.alive);
+        s.field(p.damage_cooldown); s.field(p.damage_cooldown_max);
+        s.field(p.walk); s.field(p.breath);
+        s.field(p.facing); s.field(p.moving);
+        s.field(p.just_got_hit); s.field(p.knockback_dx); s.field(p.knockback_dy); s.field(p.knockback_timer);
+        s.field(p.blocking); s.field(p.block);
+        s.field(p.is_dashing); s.field(p.dash_timer); s.field(p.dash_speed);
+        s.field(p.dash_dir_x); s.field(p.dash_dir_y); s.field(p.dash_disabled);
+    }
+
+    // Per-coin state (the frames and the clip are shared)
+    template <class Stream, class C>
+    void transfer_coin(Stream &s, C &c)
+    {
+        s.field(c.x); s.field(c.y); s.field(c.value); s.field(c.active);
+        s.field(c.anim);
+    }
+
+    template <class Stream, class World>
+    void transfer_counters(Stream &s, World &world)
+    {
+        s.field(world.rng.state);
+        s.field(world.money);
+        s.field(world.wave); s.field(world.wave_in_progress);
+        s.field(world.wave_clear_timer); s.field(world.wave_cleared_prompt); s.field(world.endless);
+        s.field(world.spawn);
+        s.field(world.current_weapon);
+        s.field(world.camera_shake_timer); s.field(world.kill_marker_timer); s.field(world.block_flash_timer);
+    }
+}
+
+void write_world(ByteWriter &w, const GameWorld &world)
+{
+    w.field(kSnapshotMagic);
+    transfer_counters(w, world);
+    transfer_player(w, world.player);
+
+    w.field<uint32_t>((uint32_t)world.weapons.size());
+    for (const auto &wp : world.weapons)
+    {
+        w.field(weapon_type_of(wp.get()));
+        if (wp) wp->save_state(w);
+    }
+
+    w.field<uint32_t>((uint32_t)world.enemies.size());
+    for (const auto &e : world.enemies)
+    {
+        w.field(e->kind());
+        e->save_state(w);
+    }
+
+    w.field<uint32_t>((uint32_t)world.coins.size());
+    for (const auto &c : world.coins)
+        transfer_coin(w, c);
+}
+
+namespace
+{
+    // One pass over a blob into `world`; may stop part way on a bad blob
+    bool decode_world(ByteReader &r, GameWorld &world)
+    {
+        if (r.get<uint32_t>() != kSnapshotMagic)
+            return false;
+        transfer_counters(r, world);
+        transfer_player(r, world.player);
+        clamp_player_anims(world.player);
+
+        uint32_t n_weapons = r.get<uint32_t>();
+        if (!r.ok() || n_weapons > 8) return false;
+        world.weapons.resize(n_weapons);
+        for (auto &wp : world.weapons)
+        {
+            WeaponType type = r.get<WeaponType>();
+            if (type != WeaponType::None && !is_weapon_type((int)type))
+                return false;
+            if (weapon_type_of(wp.get()) != type)
+            {
+                wp = create_weapon(type);
+                if (wp && !world.headless) wp->load_assets();
+            }
+            if (wp) wp->load_state(r);
+        }
+
+        uint32_t n_enemies = r.get<uint32_t>();
+        if (!r.ok() || n_enemies > 65536) return false;
+        world.enemies.resize(n_enemies);
+        for (auto &e : world.enemies)
+        {
+            EnemyKind kind = r.get<EnemyKind>();
+            if (!e || e->kind() != kind)
+            {
+                e = create_enemy(kind);
+                if (!e) return false;
+                if (!world.headless) e->load_assets();
+            }
+            e->load_state(r);
+        }
+
+        uint32_t n_coins = r.get<uint32_t>();
+        if (!r.ok() || n_coins > 65536) return false;
+        world.coins.resize(n_coins);
+        world.free_coins.clear();
+        for (int i = 0; i < (int)n_coins; ++i)
+        {
+            Coin &c = world.coins[i];
+            transfer_coin(r, c);
+            coin_clip().clamp(c.anim);
+            if (!c.active)
+                world.free_coins.push_back(i); // Ascending: already a min-heap
+        }
+
+        return r.ok();
+    }
+}
+
+bool read_world(ByteReader &r, GameWorld &world, bool to_end)
+{
+    // Decode into a scratch world first, so a blob that fails part way never
+    // leaves the live world half restored. The scratch is headless (no
+    // assets) and keeps its objects between calls, like the live world.
+    static thread_local GameWorld scratch = [] {
+        GameWorld w;
+        w.headless = true;
+        return w;
+    }();
+    ByteReader check = r;
+    if (!decode_world(check, scratch) || (to_end && !check.at_end()))
+        return false;
+    silence_weapons(world); // Looped voices of the weapons being replaced
+    return decode_world(r, world);
+}
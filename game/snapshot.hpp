@@ -0,0 +1,136 @@
+// World snapshots: the complete simulation state of a GameWorld as a flat byte
+// blob (player, enemies with their state machines, weapons and bullets,
+// coins, wave/spawn counters, RNG). Used for quick-save/quick-load.
+//
+// Values are stored with their in-memory layout, so a blob is only meant to be
+// read back by the same build. Bitmaps are never stored; objects rebind their
+// own sprites after loading.
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+struct GameWorld;
+
+// Appends fields to a byte buffer
+class ByteWriter
+{
+public:
+    explicit ByteWriter(std::vector<uint8_t> &out) : out_(out) {}
+
+    template <class T>
+    void field(const T &v)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be plain data");
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(&v);
+        out_.insert(out_.end(), p, p + sizeof(T));
+    }
+
+    // Length-prefixed vector of plain structs without padding
+    template <class T>
+    void items(const std::vector<T> &v)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot items must be plain data");
+        field<uint32_t>((uint32_t)v.size());
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(v.data());
+        out_.insert(out_.end(), p, p + v.size() * sizeof(T));
+    }
+
+    // Length-prefixed vector of structs with padding, written member by member
+    // through T::transfer so identical states give identical bytes
+    template <class T>
+    void records(const std::vector<T> &v)
+    {
+        field<uint32_t>((uint32_t)v.size());
+        for (const T &item : v)
+            T::transfer(*this, item);
+    }
+
+private:
+    std::vector<uint8_t> &out_;
+};
+
+// Reads fields back in the same order; an overrun marks the reader failed and
+// yields zeroes from then on
+class ByteReader
+{
+public:
+    ByteReader(const uint8_t *data, size_t size) : p_(data), end_(data + size) {}
+    explicit ByteReader(const std::vector<uint8_t> &in) : ByteReader(in.data(), in.size()) {}
+
+    bool ok() const { return ok_; }
+    bool at_end() const { return p_ == end_; }
+
+    template <class T>
+    void field(T &v)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be plain data");
+        if (!take(&v, sizeof(T)))
+            std::memset(static_cast<void *>(&v), 0, sizeof(T));
+    }
+
+    template <class T>
+    T get()
+    {
+        T v;
+        field(v);
+        return v;
+    }
+
+    // Reuses the vector's capacity
+    template <class T>
+    void items(std::vector<T> &v)
+    {
+        uint32_t n = get<uint32_t>();
+        if (!ok_ || (size_t)(end_ - p_) < (size_t)n * sizeof(T))
+        {
+            ok_ = false;
+            v.clear();
+            return;
+        }
+        v.resize(n);
+        take(v.data(), n * sizeof(T));
+    }
+
+    template <class T>
+    void records(std::vector<T> &v)
+    {
+        uint32_t n = get<uint32_t>();
+        if (!ok_ || (size_t)(end_ - p_) < n) // every record takes at least a byte
+        {
+            ok_ = false;
+            v.clear();
+            return;
+        }
+        v.resize(n);
+        for (T &item : v)
+            T::transfer(*this, item);
+    }
+
+private:
+    const uint8_t *p_;
+    const uint8_t *end_;
+    bool ok_ = true;
+
+    bool take(void *dst, size_t n)
+    {
+        if (!ok_ || (size_t)(end_ - p_) < n)
+        {
+            ok_ = false;
+            return false;
+        }
+        std::memcpy(dst, p_, n);
+        p_ += n;
+        return true;
+    }
+};
+
+// Serialise the whole world (appends to `out`)
+void write_world(ByteWriter &w, const GameWorld &world);
+
+// Restore a world written by write_world. Enemies and weapons that already
+// exist with the matching type are updated in place (no allocation, no asset
+// reload); others are created. Returns false on a malformed blob (with
+// `to_end`, also when bytes follow the world), leaving `world` untouched.
+bool read_world(ByteReader &r, GameWorld &world, bool to_end = false);
@@ -0,0 +1,24 @@
+// Sound and music requests. The simulation never calls SplashKit's audio
+// itself: it records what should be heard into GameWorld::sounds, and the
+// window thread plays the requests from the published frame snapshot.
+#pragma once
+#include <string>
+
+enum class SoundOp
+{
+    Play,        // One shot of effect `name` at `volume`
+    Loop,        // Effect `name` repeating until a Stop
+    Stop,        // Every voice of effect `name`
+    Music,       // Music track `name`, looping, at `volume` (replaces the current one)
+    StopMusic,
+    PauseMusic,
+    ResumeMusic
+};
+
+struct SoundEvent
+{
+    SoundOp op = SoundOp::Play;
+    std::string name, path; // Resource name and the file it loads from
+    double volume = 1.0;
+    unsigned long seq = 0;  // Order stamp, set when the event leaves the world (SoundFeed)
+};
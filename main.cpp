@@ -1,42 +1,198 @@
 #include "splashkit.h"
 #include "player/player.hpp"
 #include "weapon/weapon_base.hpp"
+#include "weapon/weapon_registry.hpp"
 #include "enemy/enemy_base.hpp"
 #include "enemy/slime/slime.hpp"
 #include "enemy/enemy_spawn.hpp"
+#include "enemy/wave_schedule.hpp"
 #include "enemy/boss/boss.hpp"
 #include "coin.hpp"
 #include "ui/shop.hpp"
 #include "ui/menu.hpp"
 #include "ui/pause.hpp"
 #include "save/save.hpp"
+#include "game/input.hpp"
+#include "game/game_world.hpp"
+#include "render/frame_snapshot.hpp"
+#include "game/snapshot.hpp"
+#include "game/rewind.hpp"
+#include "game/sim_thread.hpp"
+#include "game/audio.hpp"
 #include <memory> // for std::unique_ptr
 #include <vector>
 #include <string>
-int money = 0;                 // Player's total money
-player_data player;               // Global player instance
-int camera_shake_timer = 0;       // Screen shake timer
-int kill_marker_timer = 0;        // Kill hitmarker timer
-int block_flash_timer = 0;        // Block yellow flash timer
-int wave = 1;                     // Current wave number
-bool wave_in_progress = true;     // Whether current wave is active
-int wave_clear_timer = 0;         // Timer for wave-clear delay
-const int wave_clear_delay = 360; // Frames between waves
-std::vector<Coin> coins;          // Active coin objects
-static std::unique_ptr<WeaponBase> create_weapon_by_type(int type)
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+const double frame_budget_ms = 1000.0 / 120; // refresh_screen(120), also the tick rate
+
+// Cover `view` with copies of `tile` laid edge to edge from the arena origin
+static void draw_tiled(bitmap tile, const ViewRect &view)
+{
+    double tw = bitmap_width(tile), th = bitmap_height(tile);
+    if (tw <= 0 || th <= 0)
+        return;
+    for (double ty = std::floor(view.y / th) * th; ty < view.y + view.h; ty += th)
+        for (double tx = std::floor(view.x / tw) * tw; tx < view.x + view.w; tx += tw)
+            draw_bitmap(tile, tx, ty);
+}
+
+// Walls and crates of the snapshot (flat boxes; crates get a cross brace)
+static void draw_obstacles(const std::vector<Obstacle> &obstacles)
+{
+    for (const Obstacle &o : obstacles)
+    {
+        if (o.kind == ObstacleKind::Wall)
+        {
+            fill_rectangle(rgb_color(72, 74, 86), o.x, o.y, o.w, o.h);
+            draw_rectangle(rgb_color(40, 42, 50), o.x, o.y, o.w, o.h);
+        }
+        else
+        {
+            color edge = rgb_color(96, 62, 30);
+            fill_rectangle(rgb_color(152, 106, 60), o.x, o.y, o.w, o.h);
+            draw_rectangle(edge, o.x, o.y, o.w, o.h);
+            draw_line(edge, o.x, o.y, o.x + o.w, o.y + o.h);
+            draw_line(edge, o.x + o.w, o.y, o.x, o.y + o.h);
+        }
+    }
+}
+
+// Quick save blob: shop unlock flags followed by the world snapshot
+static bool write_quick_save(const GameWorld &world, const ShopState &shop)
+{
+    std::vector<uint8_t> blob;
+    ByteWriter w(blob);
+    w.field<uint32_t>((uint32_t)shop.items.size());
+    for (const auto &item : shop.items) w.field(item.unlocked);
+    write_world(w, world);
+    return save_quick(blob);
+}
+
+static bool read_quick_save(const std::vector<uint8_t> &blob, GameWorld &world, ShopState &shop)
+{
+    ShopState loaded;
+    init_shop_items(loaded);
+    ByteReader r(blob);
+    uint32_t n = r.get<uint32_t>();
+    if (n != loaded.items.size()) return false; // shop layout changed since the save
+    for (auto &item : loaded.items) r.field(item.unlocked);
+
+    // The world is only replaced when the whole blob is valid; the shop
+    // follows it
+    if (!r.ok() || !read_world(r, world, true)) return false;
+    shop = loaded;
+    return true;
+}
+
+// Put the world at the start of the wave `sd` was saved at (a boss wave
+// resumes in the intermission before it, so the shop comes first)
+static void restore_wave_save(const SaveData &sd, GameWorld &world, ShopState &shop)
+{
+    auto &weapons = world.weapons;
+    int &current_weapon = world.current_weapon;
+    world.money = sd.money;
+    world.endless = false;
+    world.enemies.clear();
+    reset_spawn_state(world.spawn);
+    world.coins.clear();
+    world.free_coins.clear();
+    // restore shop unlocks
+    init_shop_items(shop);
+    for (int i = 0; i < kSaveUnlockFlags && i < (int)shop.items.size(); ++i)
+        shop.items[i].unlocked = sd.unlocked[i];
+    // restore weapons
+    silence_weapons(world);
+    weapons.clear();
+    weapons.resize(2);
+    for (int s = 0; s < 2; ++s) {
+        if (is_weapon_type(sd.slot_types[s])) {
+            auto w = create_weapon((WeaponType)sd.slot_types[s]);
+            if (w) { w->load_assets(); weapons[s] = std::move(w); }
+        }
+    }
+    current_weapon = (sd.current_slot == 1 ? 1 : 0);
+    // ensure at least one weapon
+    if (!weapons[0] && !weapons[1]) {
+        auto ak = create_weapon(WeaponType::AK); ak->load_assets();
+        weapons[0] = std::move(ak);
+        current_weapon = 0;
+    }
+    // if chosen slot is empty, pick the other non-empty slot
+    if (!weapons[current_weapon]) {
+        if (current_weapon == 1 && weapons[0]) current_weapon = 0;
+        else if (current_weapon == 0 && weapons.size() > 1 && weapons[1]) current_weapon = 1;
+    }
+    bool boss_reload = sd.wave > 1 && wave_has_boss(sd.wave);
+    if (boss_reload)
+    {
+        world.wave = sd.wave - 1;
+        world.wave_in_progress = false;
+        world.wave_clear_timer = 0;
+        world.wave_cleared_prompt = true;
+    }
+    else
+    {
+        world.wave = sd.wave;
+        world.wave_in_progress = true;
+        world.wave_clear_timer = 0;
+    }
+}
+
+// The run's music; a boss switches to its own track on its next update
+static void start_run_music(GameWorld &world)
 {
-    if (type == 0) return std::make_unique<Pistol>();
-    if (type == 1) return std::make_unique<AK>();
-    if (type == 2) return std::make_unique<Shotgun>();
-    if (type == 3) return std::make_unique<AWP>();
-    return nullptr;
+    start_bgm(world, "bgm", "sound/bgm/bgm_1.mp3", 1.0);
 }
 
 int main()
 {
+    // --- World state (everything gameplay touches lives here). Once the
+    //     simulation thread starts it owns the world, the shop and the rewind
+    //     history; the window thread reaches them only through commands ---
+    GameWorld world;
+    world.rng.seed(static_cast<uint64_t>(time(nullptr)));
+    player_data &player = world.player;
+    int &money = world.money;
+    int &wave = world.wave;
+    bool &wave_in_progress = world.wave_in_progress;
+    bool &wave_cleared_prompt = world.wave_cleared_prompt;
+    std::vector<Coin> &coins = world.coins;
+    auto &enemies = world.enemies;
+    auto &weapons = world.weapons;
+    int &current_weapon = world.current_weapon;
+
     // --- Game initialization ---
+    if (!weapon_defs_error().empty())
+    {
+        write_line("Weapon definitions: " + weapon_defs_error());
+        return 1;
+    }
+    if (!enemy_defs_error().empty())
+    {
+        write_line("Enemy definitions: " + enemy_defs_error());
+        return 1;
+    }
+    if (!wave_defs_error().empty())
+    {
+        write_line("Wave definitions: " + wave_defs_error());
+        return 1;
+    }
+    if (!obstacle_defs_error().empty())
+    {
+        write_line("Obstacle layout: " + obstacle_defs_error());
+        return 1;
+    }
+    if (!mask_defs_error().empty())
+    {
+        write_line("Sprite masks: " + mask_defs_error());
+        return 1;
+    }
     load_font("arial", "C:/Windows/Fonts/arial.ttf"); // Load font (Windows path)
-    int screen_w = 1600, screen_h = 1200;
+    int screen_w = world.view_w, screen_h = world.view_h;
     open_window("Shooter - Enemy Test", screen_w, screen_h);
     hide_mouse();
     load_music("bgm", "sound/bgm/bgm_1.mp3");
@@ -44,38 +200,198 @@ int main()
     load_bitmap("background_0", "image/background/background_0.png");
     bitmap background = bitmap_named("background_0");
     // --- Player initialization ---
-    player.player_x = screen_w / 2.0;
-    player.player_y = screen_h / 2.0;
+    player.player_x = world.arena_w / 2.0;
+    player.player_y = world.arena_h / 2.0;
     player.player_speed = 2;
     load_player(player);
     // Block assets now loaded inside load_player
+    load_world_assets(world);
     load_bitmap("coin_ui", "../image/ui/coin_4.png");
+    // Shop state (also preloads every weapon sprite) and Main menu state
+    ShopState shop;
+    init_shop(shop);
+    MenuState menu;
+    init_menu(menu, save_exists() || quick_save_exists());
     // --- Weapon system setup ---
-    int current_weapon = 0; // active weapon index
-    std::vector<std::unique_ptr<WeaponBase>> weapons;
-    auto ak = std::make_unique<AK>();
+    auto ak = create_weapon(WeaponType::AK);
     ak->load_assets();
     weapons.push_back(std::move(ak));
-    auto pistol = std::make_unique<Pistol>();
+    auto pistol = create_weapon(WeaponType::Pistol);
     pistol->load_assets();
     weapons.push_back(std::move(pistol));
-    // Shop state and Main menu state
-    ShopState shop;
-    init_shop(shop);
-    MenuState menu;
-    init_menu(menu, save_exists());
-    // --- Enemy container ---
-    std::vector<std::unique_ptr<EnemyBase>> enemies;
-    // --- Post-wave coin attract timer ---
+    // --- Death recovery: R retries the wave, T rewinds a few seconds ---
+    RewindBuffer history;
+    const long rewind_ticks = 3 * 120;
+    bool playing = false;     // A run is on and unpaused (menu and pause commands switch it)
+    bool quick_saved = false; // The pause menu's last save went through
+    // --- Simulation -> window handoff ---
+    SnapshotBuffer<FrameSnapshot> frames;
+    SoundFeed sounds;
+    unsigned long tick = 0;
+    std::vector<ProjectileInfo> enemy_shots; // Scratch for the entity counter
+
+    // One simulation tick, run on the simulation thread: the open shop, the
+    // world step (unless the shop is open or the player is dead), then
+    // everything the frame draws goes into the snapshot, which is published
+    auto sim_tick = [&](const InputState &input, unsigned long commands)
+    {
+        const auto sim_start = std::chrono::steady_clock::now();
+        FrameSnapshot &snap = frames.write_slot();
+        snap.tick = tick++;
+        snap.commands = commands;
+        snap.playing = playing;
+        snap.quick_saved = quick_saved;
+        if (!playing)
+        {
+            // Main menu or pause menu: the world holds still, only the sound
+            // requests of the commands go out
+            silence_weapons(world);
+            sounds.collect(world.sounds, snap.sounds);
+            frames.publish();
+            return;
+        }
+
+        if (player.alive)
+        {
+            // Wave clear handling: show prompt; Enter (start) and B (shop)
+            // come from the window thread as commands
+            if (!wave_in_progress) wave_cleared_prompt = true;
+
+            if (shop_is_open(shop) && update_shop(shop, input, weapons, current_weapon, money))
+                close_shop(shop); // keep waiting for Enter; no save here, save snapshot only at wave start
+        }
+        const bool shop_open = shop_is_open(shop);
+        if (player.alive && !shop_open)
+            update_world(world, input);
+        else
+            silence_weapons(world); // shop open or player dead
+        if (!shop_open)
+            shop.mouse_prev_down = input.fire_down;
+
+        // ===== Per-tick effects =====
+        double shake_x = 0, shake_y = 0;
+        if (world.camera_shake_timer > 0 && !shop_open)
+        {
+            shake_x = world.rng.range(-6, 6);
+            shake_y = world.rng.range(-6, 6);
+            world.camera_shake_timer--;
+        }
+
+        if (player.just_got_hit)
+        {
+            world.camera_shake_timer = 10;
+            player.just_got_hit = false;
+        }
+
+        if (!shop_open)
+        {
+            update_coins(world);
+            if (player.alive)
+                history.tick(world); // snapshot every few ticks for T-rewind
+        }
+
+        int alive_count = world.spawn.alive;
+        int remaining_to_spawn = 0;
+        if (wave_in_progress)
+        {
+            remaining_to_spawn = world.spawn.max_in_this_wave - world.spawn.spawned_this_wave;
+            if (remaining_to_spawn < 0)
+                remaining_to_spawn = 0;
+        }
+
+        // ===== Publish this tick's render snapshot =====
+        capture_player_view(player, snap.player);
+        const ViewRect snap_view = camera_view(world);
+        snap.camera_x = snap_view.x;
+        snap.camera_y = snap_view.y;
+        snap.shake_x = shake_x;
+        snap.shake_y = shake_y;
+
+        // World layer: what the shaken camera will show
+        const ViewRect cam = {snap_view.x + shake_x, snap_view.y + shake_y, snap_view.w, snap_view.h};
+        snap.obstacles.clear();
+        for (const Obstacle &o : world.obstacles->obstacles())
+            if (cam.sees(o.x, o.y, o.w, o.h))
+                snap.obstacles.push_back(o);
+        snap.world.clear();
+        if (!player.blocking && !shop_open && current_weapon < (int)weapons.size() && weapons[current_weapon])
+            weapons[current_weapon]->capture(player, input.aim_x, input.aim_y, cam, snap.world);
+        if (!shop_open)
+            for (auto &e : enemies)
+                e->capture(cam, snap.world);
+        snap.coins.clear();
+        snap.coin_count = 0;
+        for (const auto &c : coins)
+        {
+            if (!c.active)
+                continue;
+            snap.coin_count++;
+            if (snap_view.sees(c.x, c.y, 64)) // coins off screen are never drawn
+                snap.coins.push_back({c.x, c.y, world.coin_frames[coin_clip().frame(c.anim)]});
+        }
+
+        snap.money = money;
+        snap.wave = wave;
+        snap.remaining = alive_count + remaining_to_spawn;
+        snap.wave_in_progress = wave_in_progress;
+        snap.wave_cleared_prompt = wave_cleared_prompt;
+        snap.player_alive = player.alive;
+        snap.shop_open = shop_open;
+        if (shop_open)
+            snap.shop = shop;
+        snap.endless = world.endless;
+        for (int s = 0; s < 2; ++s)
+            snap.slots[s] = weapon_type_of(s < (int)weapons.size() ? weapons[s].get() : nullptr);
+        snap.boss_bar = false;
+        if (boss_wave(world))
+        {
+            for (auto &e : enemies)
+            {
+                if (!e->alive) continue;
+                if (auto *b = dynamic_cast<Boss*>(e.get()))
+                {
+                    snap.boss_bar = true;
+                    snap.boss_ratio = (double)b->hp / (double)b->max_hp();
+                    snap.boss_enraged = b->enraged();
+                    break;
+                }
+            }
+        }
+        snap.block_flash = world.block_flash_timer > 0;
+        snap.kill_marker = world.kill_marker_timer > 0;
+        if (world.block_flash_timer > 0) world.block_flash_timer--;
+        if (world.kill_marker_timer > 0) world.kill_marker_timer--;
+
+        // Entity counts and simulation time (endless mode HUD)
+        snap.enemies_alive = world.spawn.alive;
+        snap.bullets = 0;
+        for (auto &w : weapons)
+            if (w)
+                for (const auto &b : w->bullets())
+                    snap.bullets += b.active;
+        enemy_shots.clear();
+        for (const auto &e : enemies)
+            e->collect_projectiles(enemy_shots);
+        snap.enemy_shots = (int)enemy_shots.size();
+        sounds.collect(world.sounds, snap.sounds);
+        snap.sim_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sim_start).count();
+        frames.publish();
+    };
+    SimThread sim(120, sim_tick); // Declared after everything a tick touches, so it stops first
+
+    // --- Window thread state ---
+    unsigned long posted = 0; // Serial of the last command posted to the simulation
+    PauseState pause;
+    bool aim_assist = false;  // F toggles; the crosshair turns cyan while on
+    double draw_ms = 0;       // Last frame's render time (before the present)
     // --- Main game loop ---
     while (!quit_requested())
     {
         hide_mouse();
         process_events();
-
-        bool shop_open = shop_is_open(shop);
-
-        static bool wave_cleared_prompt = false;
+        const FrameSnapshot &view = frames.read_latest();
+        sounds.play(view.sounds);
+        const bool settled = view.commands >= posted; // the snapshot shows every command's effect
 
         // Main menu gate
         if (menu.in_menu)
@@ -85,95 +401,44 @@ int main()
             draw_menu(menu, screen_w, screen_h);
             refresh_screen(120);
 
-            if (act == MenuAction::NewGame)
+            if (act == MenuAction::NewGame || act == MenuAction::Endless)
             {
-                stop_music();
-                // reset baseline
-                delete_save(); // remove old save so Continue is hidden next time
-                money = 0;
-                wave = 1;
-                wave_in_progress = true;
-                wave_clear_timer = 0;
-                enemies.clear();
-                coins.clear();
-                close_shop(shop);
-                init_shop(shop);
-                // default weapons
-                weapons.clear();
-                auto ak2 = std::make_unique<AK>(); ak2->load_assets();
-                auto pistol2 = std::make_unique<Pistol>(); pistol2->load_assets();
-                weapons.push_back(std::move(ak2));
-                weapons.push_back(std::move(pistol2));
-                // reset player state
-                player.alive = true;
-                player.max_hearts = 6;
-                player.hearts = player.max_hearts;
-                player.damage_cooldown = 0;
-                player.just_got_hit = false;
-                player.knockback_dx = player.knockback_dy = 0;
-                player.knockback_timer = 0;
-                player.blocking = false;
-                player.block_timer = 0;
-                player.dash_disabled = false;
-                player.player_speed = 2.0;
-                play_music("bgm", -1);
-                set_music_volume(1.0);
-                // start playing
+                bool endless = act == MenuAction::Endless;
+                if (!endless)
+                    delete_save(); // remove old save so Continue is hidden next time
+                posted = sim.post([&, endless] {
+                    start_new_game(world, endless); // wave 1, default weapons, fresh player
+                    history.checkpoint(world);
+                    close_shop(shop);
+                    init_shop_items(shop);
+                    start_run_music(world);
+                    playing = true;
+                });
                 menu.in_menu = false;
             }
-            else if (act == MenuAction::Continue && save_exists())
+            else if (act == MenuAction::Continue)
             {
-                SaveData sd; if (load_game(sd))
+                // The saves are read here; the world is replaced on the
+                // simulation thread
+                std::vector<uint8_t> blob;
+                SaveData sd;
+                bool quick = quick_save_exists() && load_quick(blob);
+                bool wave_save = save_exists() && load_game(sd);
+                if (quick || wave_save)
                 {
-                    stop_music();
-                    money = sd.money;
-                    enemies.clear();
-                    coins.clear();
-                    // restore shop unlocks
-                    init_shop(shop);
-                    for (int i = 0; i < 6 && i < (int)shop.items.size(); ++i)
-                        shop.items[i].unlocked = sd.unlocked[i];
-                    // restore weapons
-                    weapons.clear();
-                    weapons.resize(2);
-                    for (int s = 0; s < 2; ++s) {
-                        if (sd.slot_types[s] >= 0) {
-                            auto w = create_weapon_by_type(sd.slot_types[s]);
-                            if (w) { w->load_assets(); weapons[s] = std::move(w); }
+                    posted = sim.post([&, blob, sd, quick, wave_save] {
+                        // Resume exactly where the player saved from the
+                        // pause menu, else at the start of the saved wave
+                        if (!(quick && read_quick_save(blob, world, shop)))
+                        {
+                            if (!wave_save)
+                                return; // not playing: the window thread goes back to the menu
+                            restore_wave_save(sd, world, shop);
                         }
-                    }
-                    current_weapon = (sd.current_slot == 1 ? 1 : 0);
-                    // ensure at least one weapon
-                    if (!weapons[0] && !weapons[1]) {
-                        auto ak2 = std::make_unique<AK>(); ak2->load_assets();
-                        weapons[0] = std::move(ak2);
-                        current_weapon = 0;
-                    }
-                    // if chosen slot is empty, pick the other non-empty slot
-                    if (!weapons[current_weapon]) {
-                        if (current_weapon == 1 && weapons[0]) current_weapon = 0;
-                        else if (current_weapon == 0 && weapons.size() > 1 && weapons[1]) current_weapon = 1;
-                    }
-                    bool boss_reload = (sd.wave >= 5);
-                    if (boss_reload)
-                    {
-                        wave = 4;
-                        wave_in_progress = false;
-                        wave_clear_timer = 0;
-                        wave_cleared_prompt = true;
-                        g_spawn_timer = 0;
-                        g_last_wave = -1;
-                        g_spawned_this_wave = 0;
-                        g_max_in_this_wave = 0;
-                    }
-                    else
-                    {
-                        wave = sd.wave;
-                        wave_in_progress = true;
-                        wave_clear_timer = 0;
-                    }
-                    play_music("bgm", -1);
-                    set_music_volume(1.0);
+                        history.checkpoint(world);
+                        start_run_music(world);
+                        playing = true;
+                    });
                     menu.in_menu = false;
                 }
             }
@@ -184,266 +449,192 @@ int main()
             continue; // skip gameplay updates while in menu
         }
 
-        if (!shop_open)
+        // In-game pause menu
+        if (key_typed(ESCAPE_KEY) && settled && view.playing && !view.shop_open && !pause.active)
         {
-            if (key_typed(NUM_1_KEY) && weapons.size() > 0)
-                current_weapon = 0;
-            if (key_typed(NUM_2_KEY) && weapons.size() > 1)
-                current_weapon = 1;
+            init_pause(pause);
+            posted = sim.post([&] {
+                playing = false;
+                quick_saved = false;
+                record_sound(world, SoundOp::PauseMusic);
+            });
         }
-        // In-game pause menu
-        static PauseState pause;
-        if (key_typed(ESCAPE_KEY) && !menu.in_menu)
+        else if (pause.active)
         {
-            if (shop_is_open(shop))
+            pause.saved_highlight = settled && view.quick_saved;
+            PauseAction pa = key_typed(ESCAPE_KEY) ? PauseAction::Continue : update_pause(pause);
+            if (pa == PauseAction::Continue)
             {
-                close_shop(shop);
+                pause.active = false;
+                posted = sim.post([&] {
+                    record_sound(world, SoundOp::ResumeMusic);
+                    playing = true;
+                });
             }
-            else if (!pause.active)
+            else if (pa == PauseAction::Save)
             {
-                init_pause(pause); pause_music();
+                // Mid-wave quick save of the whole world; Continue resumes from it
+                posted = sim.post([&] { quick_saved = write_quick_save(world, shop); });
             }
-            else
+            else if (pa == PauseAction::MainMenu)
+            {
+                pause.active = false;
+                posted = sim.post([&] { stop_bgm(world); });
+                menu.in_menu = true; init_menu(menu, save_exists() || quick_save_exists());
+                continue;
+            }
+            else if (pa == PauseAction::Quit)
             {
-                pause.active = false; resume_music();
+                return 0;
             }
         }
+        if (pause.active)
+        {
+            draw_pause_menu(pause, screen_w, screen_h);
+            refresh_screen(120);
+            continue;
+        }
 
-        if (player.alive)
+        if (!view.playing)
         {
-            // Wave clear handling: show prompt, allow Enter to start, B to open shop
-            if (!wave_in_progress) wave_cleared_prompt = true;
+            if (settled)
+            {
+                // Continue found no usable save: back to the menu
+                menu.in_menu = true; init_menu(menu, save_exists() || quick_save_exists());
+            }
+            refresh_screen(120); // nothing new to show until the run starts
+            continue;
+        }
 
-            if (shop_is_open(shop))
+        // ===== Input: the simulation never polls SplashKit input itself =====
+        const bool last_wave = !view.endless && is_final_wave(view.wave);
+        if (settled)
+        {
+            if (!view.shop_open)
             {
-                bool should_close = update_shop(shop, weapons, current_weapon, money);
-                if (should_close)
-                {
-                    close_shop(shop);
-                    shop_open = false; // keep waiting for Enter
-                    // no save here; save snapshot only at wave start
-                }
+                if (key_typed(NUM_1_KEY))
+                    posted = sim.post([&] { if (!shop_is_open(shop) && weapons.size() > 0) current_weapon = 0; });
+                if (key_typed(NUM_2_KEY))
+                    posted = sim.post([&] { if (!shop_is_open(shop) && weapons.size() > 1) current_weapon = 1; });
+                if (key_typed(F_KEY))
+                    aim_assist = !aim_assist;
             }
 
-            if (!shop_is_open(shop))
+            if (view.player_alive && !view.shop_open)
             {
-                // Open/close shop with B when not in combat
-                if (key_typed(B_KEY) && !wave_in_progress)
-                {
-                    if (shop_open) close_shop(shop); else open_shop(shop);
-                }
+                // Open the shop with B when not in combat
+                if (key_typed(B_KEY) && !view.wave_in_progress)
+                    posted = sim.post([&] { if (player.alive && !wave_in_progress) open_shop(shop); });
 
                 // Start next wave on Enter when cleared
-                if (wave < 5 && wave_cleared_prompt && key_typed(RETURN_KEY))
+                if (!last_wave && view.wave_cleared_prompt && key_typed(RETURN_KEY))
                 {
-                    wave_cleared_prompt = false;
-                    wave++;
-                    wave_in_progress = true;
-                    wave_clear_timer = wave_clear_delay;
-                    // Save snapshot at the start of this wave
-                    SaveData sd; sd.money = money; sd.wave = wave; sd.slot_types[0] = -1; sd.slot_types[1] = -1; sd.current_slot = current_weapon;
-                    for (int i = 0; i < 6 && i < (int)shop.items.size(); ++i) sd.unlocked[i] = shop.items[i].unlocked;
-                    if (weapons.size() > 0 && weapons[0]) {
-                        if (dynamic_cast<Pistol*>(weapons[0].get())) sd.slot_types[0] = 0;
-                        else if (dynamic_cast<AK*>(weapons[0].get())) sd.slot_types[0] = 1;
-                        else if (dynamic_cast<Shotgun*>(weapons[0].get())) sd.slot_types[0] = 2;
-                        else if (dynamic_cast<AWP*>(weapons[0].get())) sd.slot_types[0] = 3;
-                    }
-                    if (weapons.size() > 1 && weapons[1]) {
-                        if (dynamic_cast<Pistol*>(weapons[1].get())) sd.slot_types[1] = 0;
-                        else if (dynamic_cast<AK*>(weapons[1].get())) sd.slot_types[1] = 1;
-                        else if (dynamic_cast<Shotgun*>(weapons[1].get())) sd.slot_types[1] = 2;
-                        else if (dynamic_cast<AWP*>(weapons[1].get())) sd.slot_types[1] = 3;
-                    }
-                    save_game(sd);
+                    posted = sim.post([&] {
+                        if (!player.alive || shop_is_open(shop) || final_wave(world) || !wave_cleared_prompt)
+                            return;
+                        begin_next_wave(world);
+                        history.checkpoint(world);
+                        // Save snapshot at the start of this wave (story only: the
+                        // save format has no mode, endless runs use the quick save)
+                        if (!world.endless)
+                        {
+                            SaveData sd; sd.money = money; sd.wave = wave; sd.current_slot = current_weapon;
+                            for (int i = 0; i < kSaveUnlockFlags && i < (int)shop.items.size(); ++i) sd.unlocked[i] = shop.items[i].unlocked;
+                            for (int s = 0; s < 2; ++s)
+                                sd.slot_types[s] = (int)weapon_type_of(s < (int)weapons.size() ? weapons[s].get() : nullptr);
+                            save_game_async(sd); // written by the saver thread, never stalls a tick
+                        }
+                        delete_quick_save();  // a mid-wave save from the previous wave is now stale
+                    });
                 }
+            }
 
-                if (pause.active)
-                {
-                    PauseAction pa = update_pause(pause);
-                    if (pa == PauseAction::Continue)
-                    {
-                        pause.active = false; resume_music();
-                    }
-                    else if (pa == PauseAction::Save)
-                    {
-                        // Disabled: only save at wave start
-                        pause.saved_highlight = false;
-                    }
-                    else if (pa == PauseAction::MainMenu)
-                    {
-                        pause.active = false;
-                        stop_music();
-                        menu.in_menu = true; init_menu(menu, save_exists());
-                        continue;
-                    }
-                    else if (pa == PauseAction::Quit)
+            bool retry = key_typed(R_KEY), rewind_back = key_typed(T_KEY);
+            if (!view.player_alive && (retry || rewind_back))
+            {
+                posted = sim.post([&, retry] {
+                    // Restores into the existing entities; no assets are reloaded
+                    if (player.alive)
+                        return;
+                    bool restored = retry ? history.retry(world) : history.rewind(world, rewind_ticks);
+                    if (!restored)
+                        return;
+                    if (retry && boss_wave(world) && player.max_hearts < 12)
                     {
-                        return 0;
+                        player.max_hearts += 1; // boss retry bonus heart, up to 12
+                        player.hearts = player.max_hearts;
                     }
+                    player.just_got_hit = false;
+                    world.camera_shake_timer = 0;
+                    start_run_music(world);
+                });
+            }
 
-                    draw_pause_menu(pause, screen_w, screen_h);
-                    refresh_screen(120);
-                    continue;
-                }
-
-                // Update blocking inside player module
-                update_player_block(player);
-
-                if (!player.blocking)
-                {
-                    player.dash_disabled = false;
-                    player.player_speed = 2.0;
-                    update_player(player);
-                }
-
-
-                // Safe active weapon selection
-                int active_idx = current_weapon;
-                if (active_idx >= (int)weapons.size() || !weapons[active_idx])
-                {
-                    if (weapons.size() > 0 && weapons[0]) active_idx = 0;
-                    else if (weapons.size() > 1 && weapons[1]) active_idx = 1;
-                    else active_idx = -1;
-                    if (active_idx != -1) current_weapon = active_idx;
-                }
-                if (active_idx != -1)
-                {
-                    weapons[active_idx]->update(player);
-                    for (auto &e : enemies)
-                        e->update(player, weapons[active_idx]->bullets());
-                }
-
-                if (wave_in_progress)
-                {
-                    spawn_enemies(enemies, wave, wave_in_progress);
-                }
-                // When not in progress, wait for Enter (no auto start)
+            // Boss defeated: Enter returns to the main menu
+            if (!view.wave_in_progress && last_wave && key_typed(RETURN_KEY))
+            {
+                delete_save();
+                posted = sim.post([&] {
+                    playing = false;
+                    stop_bgm(world);
+                });
+                menu.in_menu = true; init_menu(menu, save_exists() || quick_save_exists());
+                continue;
             }
         }
+        InputState input = sample_input(view.camera_x, view.camera_y); // what the player saw when aiming
+        input.aim_assist = aim_assist;
+        sim.set_input(input);
 
-        shop_open = shop_is_open(shop);
+        // ===== Render: world layer and HUD read only from the snapshot =====
+        const auto draw_start = std::chrono::steady_clock::now();
 
-        double shake_x = 0, shake_y = 0;
-        if (camera_shake_timer > 0 && !shop_open)
-        {
-            shake_x = rnd(-6, 6);
-            shake_y = rnd(-6, 6);
-            camera_shake_timer--;
-        }
-
-        draw_bitmap(background, shake_x, shake_y);
+        // World layer, in arena coordinates under the camera (shake moves the
+        // whole view); the snapshot holds only what `cam` shows
+        ViewRect cam = {view.camera_x + view.shake_x, view.camera_y + view.shake_y, (double)screen_w, (double)screen_h};
+        move_camera_to(cam.x, cam.y);
+        draw_tiled(background, cam);
+        draw_obstacles(view.obstacles);
 
-        if (!player.blocking)
-        {
-            if (player.damage_cooldown > 0)
-            {
-                if ((player.damage_cooldown / 5) % 2 == 0)
-                    draw_player(player);
-            }
-            else
-            {
-                draw_player(player);
-            }
-        }
+        draw_player(view.player);
 
         // Draw block flash effect
-        if (block_flash_timer > 0)
+        if (view.block_flash)
         {
-            double cxp = player.player_x + player.player_width/2;
-            double cyp = player.player_y + player.player_hight/2;
+            double cxp = view.player.x + view.player.w/2;
+            double cyp = view.player.y + view.player.h/2;
             color yel = COLOR_YELLOW; double len = 34;
             draw_line(yel, cxp - len, cyp, cxp + len, cyp);
             draw_line(yel, cxp, cyp - len, cxp, cyp + len);
-            block_flash_timer--;
         }
 
-        if (!player.blocking && !shop_open)
-        {
-            int active_idx = current_weapon;
-            if (active_idx >= (int)weapons.size() || !weapons[active_idx])
-            {
-                if (weapons.size() > 0 && weapons[0]) active_idx = 0;
-                else if (weapons.size() > 1 && weapons[1]) active_idx = 1;
-                else active_idx = -1;
-                if (active_idx != -1) current_weapon = active_idx;
-            }
-            if (active_idx != -1) weapons[active_idx]->draw(player);
-        }
-
-        if (!shop_open)
-            for (auto &e : enemies)
-                e->draw();
-
-        // Boss HP bar (top)
-        if (wave == 5)
-        {
-            for (auto &e : enemies)
-            {
-                if (!e->alive) continue;
-                if (auto *b = dynamic_cast<Boss*>(e.get()))
-                {
-                    double ratio = (double)b->hp / (double)b->max_hp();
-                    double bar_w = 800; double bar_h = 16;
-                    double bx = screen_w/2 - bar_w/2; double by = 60;
-                    color bar_color = b->enraged() ? COLOR_RED : COLOR_PURPLE;
-                    fill_rectangle(bar_color, bx, by, bar_w * ratio, bar_h);
-                    draw_rectangle(COLOR_BLACK, bx, by, bar_w, bar_h);
-                    break;
-                }
-            }
-        }
+        // Enemies, the held weapon, bullets and their effects
+        draw_world_layer(view.world);
 
         // Draw block overlay when blocking
-        draw_player_block_overlay(player);
+        draw_player_block_overlay(view.player);
 
-        if (player.just_got_hit)
-        {
-            camera_shake_timer = 10;
-            player.just_got_hit = false;
-        }
+        for (const auto &c : view.coins)
+            draw_bitmap(c.frame, c.x, c.y);
+
+        // Screen layer: HUD, shop and prompts
+        move_camera_to(0, 0);
 
-        for (auto &c : coins)
+        // Boss HP bar (top)
+        if (view.boss_bar)
         {
-            if (!c.active)
-                continue;
-            draw_bitmap(c.frames[c.frame], c.x, c.y);
+            double bar_w = 800; double bar_h = 16;
+            double bx = screen_w/2 - bar_w/2; double by = 60;
+            color bar_color = view.boss_enraged ? COLOR_RED : COLOR_PURPLE;
+            fill_rectangle(bar_color, bx, by, bar_w * view.boss_ratio, bar_h);
+            draw_rectangle(COLOR_BLACK, bx, by, bar_w, bar_h);
         }
 
-        draw_player_hp(player);
+        draw_player_hp(view.player);
 
-        if (shop_open)
+        if (view.shop_open)
         {
-            draw_shop(shop, weapons, money, screen_w);
-        }
-
-        if (!shop_open)
-        {
-            for (auto &c : coins)
-            {
-                if (!c.active)
-                    continue;
-                c.frame_timer++;
-                if (c.frame_timer >= c.frame_interval)
-                {
-                    c.frame = (c.frame + 1) % c.frame_count;
-                    c.frame_timer = 0;
-                }
-                double dx = player.player_x - c.x;
-                double dy = player.player_y - c.y;
-                double dist = sqrt(dx * dx + dy * dy);
-                if (dist > 1)
-                {
-                    double suck_speed = 10.0; // slower coin speed
-                    c.x += (dx / dist) * suck_speed;
-                    c.y += (dy / dist) * suck_speed;
-                }
-                if (dist < 75)
-                {
-                    money += (int)c.value;
-                    c.active = false;
-                }
-            }
+            draw_shop(view.shop, view.slots, view.money, screen_w);
         }
 
         // Draw coin UI to the right of HP hearts (6 hearts width)
@@ -451,92 +642,46 @@ int main()
         double hp_block_w = 20 + 6*48; // left margin + 6 hearts
         double coin_x = hp_block_w + 40; double coin_y = 20;
         draw_bitmap(coin_ui, coin_x, coin_y);
-        draw_text("x " + std::to_string(money), COLOR_BLACK, "arial", 32, coin_x + 50, coin_y + 5);
+        draw_text("x " + std::to_string(view.money), COLOR_BLACK, "arial", 32, coin_x + 50, coin_y + 5);
 
-        if (!player.alive)
+        if (!view.player_alive)
         {
             draw_text("GAME OVER!", COLOR_RED, "arial", 64, screen_w / 2 - 200, screen_h / 2 - 50);
-            if (wave == 5)
-                draw_text("Press 'R' to return to pre-boss intermission", COLOR_BLACK, "arial", 32, screen_w / 2 - 320, screen_h / 2 + 40);
-            else
-                draw_text("Press 'R' to Restart", COLOR_BLACK, "arial", 32, screen_w / 2 - 180, screen_h / 2 + 40);
-            if (key_typed(R_KEY))
-            {
-                player.alive = true;
-                player.knockback_dx = player.knockback_dy = 0;
-                player.knockback_timer = 0;
-                player.damage_cooldown = 0;
-                player.just_got_hit = false;
-                player.blocking = false; player.block_timer = 0; player.dash_disabled = false;
-                player.player_x = screen_w / 2.0; player.player_y = screen_h / 2.0; player.player_speed = 2.0;
-
-                enemies.clear();
-                coins.clear();
-                camera_shake_timer = 0;
-
-                if (wave == 5)
-                {
-                    // Return to wave4 intermission (pre-boss)
-                    if (player.max_hearts < 12) player.max_hearts += 1; // increase a heart up to 12
-                    player.hearts = player.max_hearts;
-                    wave = 4;
-                    wave_in_progress = false;
-                    wave_clear_timer = 0;
-                    wave_cleared_prompt = true;
-                    stop_music();
-                    play_music("bgm", -1);
-                    set_music_volume(1.0);
-                    g_spawn_timer = 0;
-                    g_last_wave = -1;
-                    g_spawned_this_wave = 0;
-                    g_max_in_this_wave = 0;
-                }
-                else
-                {
-                    // Normal restart to wave 1
-                    weapons.clear();
-                    auto ak2 = std::make_unique<AK>(); ak2->load_assets(); weapons.push_back(std::move(ak2));
-                    auto pistol2 = std::make_unique<Pistol>(); pistol2->load_assets(); weapons.push_back(std::move(pistol2));
-                    current_weapon = 0;
-                    money = 1000;
-                    wave = 1; wave_in_progress = true; wave_clear_timer = 0;
-                    close_shop(shop); init_shop(shop);
-                }
-                continue;
-            }
+            draw_text("Press 'R' to retry the wave, 'T' to rewind 3 seconds", COLOR_BLACK, "arial", 32, screen_w / 2 - 360, screen_h / 2 + 40);
         }
 
-        int alive_count = 0;
-        for (auto &e : enemies)
-            if (e->alive)
-                alive_count++;
-        int remaining_to_spawn = 0;
-        if (wave_in_progress)
+        // Boss wave / boss countdown HUD
+        if (!view.endless && wave_has_boss(view.wave))
         {
-            extern int g_max_in_this_wave;
-            extern int g_spawned_this_wave;
-            remaining_to_spawn = g_max_in_this_wave - g_spawned_this_wave;
-            if (remaining_to_spawn < 0)
-                remaining_to_spawn = 0;
+            draw_text("BOSS FIGHT", COLOR_RED, "arial", 36, screen_w / 2 - 120, 10);
         }
-        int remaining_total = alive_count + remaining_to_spawn;
-        // Boss wave / boss countdown HUD
-        if (wave < 5)
+        else
         {
-            int to_boss = 5 - wave;
-            draw_text("Wave: " + std::to_string(wave) + "  Remaining: " + std::to_string(remaining_total) + "  Boss in " + std::to_string(to_boss) + " wave(s)",
-                      COLOR_BLACK, "arial", 28, screen_w / 2 - 280, 10);
+            std::string hud = "Wave: " + std::to_string(view.wave) + "  Remaining: " + std::to_string(view.remaining);
+            int next_boss = view.endless ? 0 : next_boss_wave(view.wave);
+            if (next_boss > 0)
+                hud += "  Boss in " + std::to_string(next_boss - view.wave) + " wave(s)";
+            draw_text(hud, COLOR_BLACK, "arial", 28, screen_w / 2 - 280, 10);
         }
-        else if (wave == 5)
+
+        // Endless mode doubles as the stress test: entity counts and frame budget
+        if (view.endless)
         {
-            draw_text("BOSS FIGHT", COLOR_RED, "arial", 36, screen_w / 2 - 120, 10);
+            char line[160];
+            std::snprintf(line, sizeof line, "Enemies %d  Bullets %d  Enemy shots %d  Coins %d",
+                          view.enemies_alive, view.bullets, view.enemy_shots, view.coin_count);
+            draw_text(line, COLOR_BLACK, "arial", 20, 20, screen_h - 56);
+            std::snprintf(line, sizeof line, "sim %.2f ms  draw %.2f ms  (budget %.1f ms)",
+                          view.sim_ms, draw_ms, frame_budget_ms);
+            bool over = view.sim_ms + draw_ms > frame_budget_ms;
+            draw_text(line, over ? COLOR_RED : COLOR_BLACK, "arial", 20, 20, screen_h - 30);
         }
 
         static double spread = 10;
         const double line_len = 8;
         double cx = mouse_x(), cy = mouse_y();
-        color cross_color = COLOR_GREEN;
-        if (mouse_down(LEFT_BUTTON))
+        color cross_color = input.aim_assist ? COLOR_CYAN : COLOR_GREEN;
+        if (input.fire_down)
         {
             spread += 0.6;
             if (spread > 20)
@@ -554,7 +699,7 @@ int main()
         draw_line(cross_color, cx, cy + spread, cx, cy + spread + line_len);
 
         // Kill hitmarker: draw a red version of the crosshair rotated 45°
-        if (kill_marker_timer > 0)
+        if (view.kill_marker)
         {
             color kc = COLOR_RED;
             double inv = 0.70710678; // 1/sqrt(2)
@@ -576,18 +721,16 @@ int main()
             // -diag2
             double x4 = cx - ux2 * d, y4 = cy - uy2 * d;
             draw_line(kc, x4, y4, x4 - ux2 * l, y4 - uy2 * l);
-            kill_marker_timer--;
         }
 
         // Wave cleared prompt text (center screen)
-        if (!wave_in_progress)
+        if (!view.wave_in_progress)
         {
-            if (wave == 5)
+            if (!view.endless && is_final_wave(view.wave))
             {
                 std::string l = "BOSS defeated! Press \"Enter\" to return to Main Menu";
                 double s = 26; double w = l.size()*s*0.6; double x = screen_w/2 - w/2; double y = screen_h/2 - 20;
                 draw_text(l, COLOR_YELLOW, "arial", (int)s, x, y);
-                if (key_typed(RETURN_KEY)) { menu.in_menu = true; init_menu(menu, save_exists()); stop_music(); delete_save(); }
             }
             else
             {
@@ -599,10 +742,8 @@ int main()
             }
         }
 
+        draw_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - draw_start).count();
         refresh_screen(120);
-
-        if (!shop_open)
-            shop.mouse_prev_down = mouse_down(LEFT_BUTTON);
     }
     return 0;
 }
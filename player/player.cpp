@@ -1,5 +1,53 @@
 #include "splashkit.h"
 #include "player.hpp"
+#include "../render/sprite_cache.hpp"
+#include <cmath>
+
+namespace
+{
+    // Animation clips, shared by every player (frames index the sheet below)
+    const AnimClip walk_clip = AnimClip::uniform(5, 8, true);    // 8 frames per walk frame
+    const AnimClip breath_clip = AnimClip::uniform(3, 60, true); // 60 frames per breath frame
+    const AnimClip block_clip = AnimClip::uniform(4, 5, false);  // Played once: the block lasts its length
+
+    // Player sprites, loaded once by load_player
+    struct PlayerSheet
+    {
+        bitmap walk[5] = {};
+        bitmap breath[3] = {};
+        bitmap block[4] = {};
+    } sheet;
+}
+
+// Reset the player's numeric state (no resources touched, safe for headless worlds)
+void reset_player_state(player_data &player)
+{
+    // Breathing and walking animations from their first frame
+    player.breath = {};
+    player.walk = {};
+
+    // Set default direction and health
+    player.facing = FACING_LEFT;   // Initial facing direction
+    player.hearts = 6;             // Current health (hearts)
+    player.max_hearts = 6;         // Maximum health (hearts)
+
+    player.alive = true;           // Player alive status
+    player.player_speed = 2.0;     // Base movement speed
+
+    // Init damage cooldown (prevent continuous damage)
+    player.damage_cooldown = 0;        // Current damage cooldown timer
+    player.damage_cooldown_max = 240;  // Max damage cooldown (~4 seconds)
+
+    // Hit feedback, block and dash back to idle
+    player.just_got_hit = false;
+    player.knockback_dx = player.knockback_dy = 0;
+    player.knockback_timer = 0;
+    player.blocking = false;
+    player.block = {};
+    player.is_dashing = false;
+    player.dash_timer = 0;
+    player.dash_disabled = false;
+}
 
 // Load player image resources
 void load_player(player_data &player)
@@ -16,93 +64,75 @@ void load_player(player_data &player)
     load_bitmap("Lumine_breath_1", "../image/player/player_breath/Lumine_breath_1.png");
     load_bitmap("Lumine_breath_2", "../image/player/player_breath/Lumine_breath_2.png");
 
-    // Store breathing animation frames in array
-    player.breath_frames[0] = bitmap_named("Lumine_breath_0");
-    player.breath_frames[1] = bitmap_named("Lumine_breath_1");
-    player.breath_frames[2] = bitmap_named("Lumine_breath_2");
-
-    // Init breathing animation parameters
-    player.breath_frame = 0;       // Current breathing frame index
-    player.breath_timer = 0;       // Timer for breathing frame switch
-    player.breath_interval = 60;   // Frame interval for breathing animation switch (60 frames)
-
-    // Store walking animation frames in array
-    player.frames[0] = bitmap_named("Lumine_walking_0");
-    player.frames[1] = bitmap_named("Lumine_walking_1");
-    player.frames[2] = bitmap_named("Lumine_walking_2");
-    player.frames[3] = bitmap_named("Lumine_walking_3");
-    player.frames[4] = bitmap_named("Lumine_walking_4");
-
-    // Init walking animation parameters
-    player.current_frame = 0;      // Current walking frame index
-    player.frame_timer = 0;        // Timer for walking frame switch
-    player.frame_interval = 8;     // Frame interval for walking animation switch (8 frames)
-
-    // Set default direction and health
-    player.facing = FACING_LEFT;   // Initial facing direction
-    player.hearts = 6;             // Current health (hearts)
-    player.max_hearts = 6;         // Maximum health (hearts)
+    // Store breathing animation frames in the sheet
+    sheet.breath[0] = bitmap_named("Lumine_breath_0");
+    sheet.breath[1] = bitmap_named("Lumine_breath_1");
+    sheet.breath[2] = bitmap_named("Lumine_breath_2");
 
-    player.alive = true;           // Player alive status
+    // Store walking animation frames in the sheet
+    sheet.walk[0] = bitmap_named("Lumine_walking_0");
+    sheet.walk[1] = bitmap_named("Lumine_walking_1");
+    sheet.walk[2] = bitmap_named("Lumine_walking_2");
+    sheet.walk[3] = bitmap_named("Lumine_walking_3");
+    sheet.walk[4] = bitmap_named("Lumine_walking_4");
 
-    // Init damage cooldown (prevent continuous damage)
-    player.damage_cooldown = 0;        // Current damage cooldown timer
-    player.damage_cooldown_max = 240;  // Max damage cooldown (~4 seconds)
     // Preload UI hearts once during player setup
     load_bitmap("heart_full", "../image/ui/heart_full.png");
     load_bitmap("heart_empty", "../image/ui/heart_empty.png");
 
-    // Load block overlay frames and defaults
+    // Load block overlay frames
     load_bitmap("player_block_0", "../image/player/player_block/player_block_0.png");
     load_bitmap("player_block_1", "../image/player/player_block/player_block_1.png");
     load_bitmap("player_block_2", "../image/player/player_block/player_block_2.png");
     load_bitmap("player_block_3", "../image/player/player_block/player_block_3.png");
-    player.block_frames[0] = bitmap_named("player_block_0");
-    player.block_frames[1] = bitmap_named("player_block_1");
-    player.block_frames[2] = bitmap_named("player_block_2");
-    player.block_frames[3] = bitmap_named("player_block_3");
-    player.block_duration = 20;
-    player.block_interval = 5;
+    sheet.block[0] = bitmap_named("player_block_0");
+    sheet.block[1] = bitmap_named("player_block_1");
+    sheet.block[2] = bitmap_named("player_block_2");
+    sheet.block[3] = bitmap_named("player_block_3");
+
+    reset_player_state(player);
 }
 
-// Draw current player frame
-void draw_player(player_data &player)
+// Capture what the renderer needs from the player for this tick
+void capture_player_view(const player_data &player, PlayerView &out)
 {
-    bitmap frame;
+    out.x = player.player_x;
+    out.y = player.player_y;
+    out.w = player.player_width;
+    out.h = player.player_hight;
+    out.facing = player.facing;
 
     // Use walking animation if moving, else breathing animation
-    if (key_down(A_KEY) || key_down(D_KEY) || key_down(W_KEY) || key_down(S_KEY))
-    {
-        frame = player.frames[player.current_frame];
-    }
+    if (player.moving)
+        out.frame = sheet.walk[walk_clip.frame(player.walk)];
     else
-    {
-        frame = player.breath_frames[player.breath_frame];
-    }
+        out.frame = sheet.breath[breath_clip.frame(player.breath)];
 
-    // Draw based on facing direction (flip for left)
-    if (player.facing == FACING_LEFT)
-    {
-        drawing_options opts = option_flip_y();
-        draw_bitmap(frame, player.player_x, player.player_y, opts);
-    }
-    else
-    {
-        draw_bitmap(frame, player.player_x, player.player_y);
-    }
+    out.blocking = player.blocking;
+    out.block_frame = player.blocking ? sheet.block[block_clip.frame(player.block)] : nullptr;
+
+    // Blink while invulnerable after a hit
+    out.visible = player.damage_cooldown <= 0 || (player.damage_cooldown / 5) % 2 == 0;
+
+    out.hearts = player.hearts;
+    out.max_hearts = player.max_hearts;
 }
 
-// Global variables for dash system
-bool is_dashing = false;      // Dash status flag
-int dash_timer = 0;           // Dash duration timer (frames)
-double dash_speed = 0;        // Dash movement speed
-double dash_dir_x = 0;        // Dash X direction (-1, 0, 1)
-double dash_dir_y = 0;        // Dash Y direction (-1, 0, 1)
+// Draw current player frame
+void draw_player(const PlayerView &view)
+{
+    if (view.blocking || !view.visible || !view.frame)
+        return;
+
+    // Draw based on facing direction (the cached mirror for left)
+    sprite_variants(view.frame).draw(view.x, view.y, view.facing == FACING_LEFT);
+}
 
 // Update player state (movement/dash/animation)
-void update_player(player_data &player)
+void update_player(player_data &player, const InputState &in, int arena_w, int arena_h)
 {
     bool moving = false;
+    player.moving = false;
     // Knockback handling
     if (player.knockback_timer > 0)
     {
@@ -118,110 +148,91 @@ void update_player(player_data &player)
     }
 
     // Trigger dash on Left Shift press (if not dashing and moving)
-    if (key_typed(LEFT_SHIFT_KEY) && !is_dashing && !player.dash_disabled &&
-        (key_down(W_KEY) || key_down(A_KEY) || key_down(S_KEY) || key_down(D_KEY)))
+    if (in.dash_pressed && !player.is_dashing && !player.dash_disabled && in.moving())
     {
-        is_dashing = true;
-        dash_timer = 10; // Dash duration (10 frames)
-        dash_speed = 20; // Dash speed value
-        dash_dir_x = 0;
-        dash_dir_y = 0;
+        player.is_dashing = true;
+        player.dash_timer = 10; // Dash duration (10 frames)
+        player.dash_speed = 20; // Dash speed value
+        player.dash_dir_x = 0;
+        player.dash_dir_y = 0;
 
         // Determine dash direction from key presses
-        if (key_down(W_KEY))
-            dash_dir_y = -1;
-        if (key_down(S_KEY))
-            dash_dir_y = 1;
-        if (key_down(A_KEY))
-            dash_dir_x = -1;
-        if (key_down(D_KEY))
-            dash_dir_x = 1;
+        if (in.move_up)
+            player.dash_dir_y = -1;
+        if (in.move_down)
+            player.dash_dir_y = 1;
+        if (in.move_left)
+            player.dash_dir_x = -1;
+        if (in.move_right)
+            player.dash_dir_x = 1;
 
         // Normalize direction vector (prevent faster diagonal movement)
-        double len = sqrt(dash_dir_x * dash_dir_x + dash_dir_y * dash_dir_y);
+        double len = sqrt(player.dash_dir_x * player.dash_dir_x + player.dash_dir_y * player.dash_dir_y);
         if (len > 0)
         {
-            dash_dir_x /= len;
-            dash_dir_y /= len;
+            player.dash_dir_x /= len;
+            player.dash_dir_y /= len;
         }
     }
 
     // Dash state
-    if (is_dashing)
+    if (player.is_dashing)
     {
-        player.player_x += dash_dir_x * dash_speed;
-        player.player_y += dash_dir_y * dash_speed;
-        dash_timer--;
+        player.player_x += player.dash_dir_x * player.dash_speed;
+        player.player_y += player.dash_dir_y * player.dash_speed;
+        player.dash_timer--;
 
         // End dash when timer ends
-        if (dash_timer <= 0)
+        if (player.dash_timer <= 0)
         {
-            is_dashing = false;
+            player.is_dashing = false;
         }
     }
     else // Normal movement
     {
-        if (key_down(A_KEY))
+        if (in.move_left)
             player.player_x -= player.player_speed,
                 player.facing = FACING_LEFT,
                 moving = true;
-        if (key_down(D_KEY))
+        if (in.move_right)
             player.player_x += player.player_speed,
                 player.facing = FACING_RIGHT,
                 moving = true;
-        if (key_down(W_KEY))
+        if (in.move_up)
             player.player_y -= player.player_speed,
                 moving = true;
-        if (key_down(S_KEY))
+        if (in.move_down)
             player.player_y += player.player_speed,
                 moving = true;
     }
 
-    // Update walking animation
-    if (moving)
-    {
-        player.frame_timer++;
-        if (player.frame_timer >= player.frame_interval)
-        {
-            player.current_frame = (player.current_frame + 1) % 5;
-            player.frame_timer = 0;
-        }
-    }
-    else
-    {
-        player.current_frame = 0;
-        player.frame_timer = 0;
-    }
+    player.moving = moving;
 
-    // Update breathing animation
-    if (!moving)
+    // Walk while moving, breathe while standing; the other clip restarts
+    if (moving)
     {
-        player.breath_timer++;
-        if (player.breath_timer >= player.breath_interval)
-        {
-            player.breath_frame = (player.breath_frame + 1) % 3;
-            player.breath_timer = 0;
-        }
+        walk_clip.step(player.walk);
+        player.breath = {};
     }
     else
     {
-        player.breath_timer = 0;
-        player.breath_frame = 0;
+        breath_clip.step(player.breath);
+        player.walk = {};
     }
 
-    // Screen boundary constraints
+    // Arena boundary constraints
     if (player.player_x < 0)
         player.player_x = 0;
     if (player.player_y < 0)
         player.player_y = 0;
-    if (player.player_x > 1600 - 48)  // 1600: screen width; 48: player width
-        player.player_x = 1600 - 48;
-    if (player.player_y > 1200 - 48)  // 1200: screen height; 48: player height
-        player.player_y = 1200 - 48;
+    if (player.player_x > arena_w - player.player_width)
+        player.player_x = arena_w - player.player_width;
+    if (player.player_y > arena_h - player.player_hight)
+        player.player_y = arena_h - player.player_hight;
 }
 
 // Draw player health bar
-void draw_player_hp(const player_data &player)
+void draw_player_hp(const PlayerView &view)
 {
     bitmap heart_full = bitmap_named("heart_full");
     bitmap heart_empty = bitmap_named("heart_empty");
@@ -231,54 +242,50 @@ void draw_player_hp(const player_data &player)
     double gap = 0;
     double size = 48;
     int per_row = 6; // 6 per row, then wrap
-    for (int i = 0; i < player.max_hearts; i++)
+    for (int i = 0; i < view.max_hearts; i++)
     {
         int row = i / per_row;
         int col = i % per_row;
         double x = start_x + col * (size + gap);
         double y = start_y + row * (size + gap);
-        if (i < player.hearts) draw_bitmap(heart_full, x, y);
+        if (i < view.hearts) draw_bitmap(heart_full, x, y);
         else draw_bitmap(heart_empty, x, y);
     }
 }
 
 // === Blocking logic moved from main ===
-void update_player_block(player_data &player)
+void update_player_block(player_data &player, const InputState &in)
 {
-    if (key_typed(SPACE_KEY) && !player.blocking && player.knockback_timer <= 0)
+    if (in.block_pressed && !player.blocking && player.knockback_timer <= 0)
     {
         player.blocking = true;
-        player.block_timer = player.block_duration;
-        player.block_frame = 0;
+        player.block = {};
     }
 
     if (player.blocking)
     {
-        player.block_timer--;
-        if (player.block_timer <= 0)
-        {
+        block_clip.step(player.block);
+        if (block_clip.done(player.block))
             player.blocking = false;
-            player.block_frame = 0;
-        }
-        else if ((player.block_duration - player.block_timer) % player.block_interval == 0)
-        {
-            player.block_frame = (player.block_frame + 1) % 4;
-        }
     }
 }
 
-void draw_player_block_overlay(const player_data &player)
+int player_block_duration()
+{
+    return block_clip.length();
+}
+
+void clamp_player_anims(player_data &player)
 {
-    if (!player.blocking) return;
-    bitmap bframe = player.block_frames[player.block_frame];
+    walk_clip.clamp(player.walk);
+    breath_clip.clamp(player.breath);
+    block_clip.clamp(player.block);
+}
+
+void draw_player_block_overlay(const PlayerView &view)
+{
+    if (!view.blocking) return;
+    bitmap bframe = view.block_frame;
     if (!bframe) return;
-    if (player.facing == FACING_LEFT)
-    {
-        drawing_options opts = option_flip_y();
-        draw_bitmap(bframe, player.player_x, player.player_y, opts);
-    }
-    else
-    {
-        draw_bitmap(bframe, player.player_x, player.player_y);
-    }
+    sprite_variants(bframe).draw(view.x, view.y, view.facing == FACING_LEFT);
 }
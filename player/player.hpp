@@ -1,5 +1,7 @@
 #pragma once
 #include "splashkit.h"
+#include "../game/input.hpp"
+#include "../game/anim_clip.hpp"
 
 // Player facing direction
 enum direction
@@ -22,17 +24,12 @@ struct player_data
     int damage_cooldown;          // Cooldown after taking damage
     int damage_cooldown_max;      // Max duration of damage cooldown
 
-    bitmap frames[5];             // Animation frames
-    int current_frame;            // Current animation frame index
-    int frame_timer;              // Timer for frame switching
-    int frame_interval;           // Interval between frame updates
-
-    bitmap breath_frames[3];      // Breath animation frames
-    int breath_frame;             // Current breath frame index
-    int breath_timer;             // Timer for breath frame switching
-    int breath_interval;          // Interval between breath frame updates
+    // Animation playheads (the clips and sprites are shared, see player.cpp)
+    AnimPlayhead walk;            // Walk clip, while moving
+    AnimPlayhead breath;          // Breath clip, while standing
 
     direction facing;             // Current facing direction
+    bool moving = false;          // Moved under player control this tick
 
     // Hit feedback system
     bool just_got_hit = false;    // Whether hit in current frame
@@ -41,22 +38,43 @@ struct player_data
     int knockback_timer = 0;      // Knockback duration timer
 
     // Blocking system (Space to block)
-    bool blocking = false;        // Currently blocking
-    bitmap block_frames[4];       // Block animation frames
-    int block_frame = 0;          // Current block frame index
-    int block_timer = 0;          // Remaining block frames
-    int block_interval = 5;       // Frames between block animation updates
-    int block_duration = 20;      // Total block duration (frames)
+    bool blocking = false;        // Currently blocking (until the block clip ends)
+    AnimPlayhead block;           // Block overlay clip
+
+    // Dash system
+    bool is_dashing = false;      // Dash status flag
+    int dash_timer = 0;           // Dash duration timer (frames)
+    double dash_speed = 0;        // Dash movement speed
+    double dash_dir_x = 0;        // Dash X direction (-1, 0, 1)
+    double dash_dir_y = 0;        // Dash Y direction (-1, 0, 1)
 
     // Movement modifiers from weapons
     bool dash_disabled = false;   // If true, cannot dash
 };
 
-void draw_player(player_data &player);       // Draw the player
-void update_player(player_data &player);     // Update player state
-void load_player(player_data &player);       // Load player resources
-void draw_player_hp(const player_data &player);  // Draw player's HP
+// Render-side copy of the player, captured once per tick into the frame snapshot
+struct PlayerView
+{
+    double x = 0, y = 0;          // Player position
+    double w = 0, h = 0;          // Player size
+    direction facing = FACING_LEFT;
+    bitmap frame = nullptr;       // Walk or breath frame picked by the simulation
+    bitmap block_frame = nullptr; // Block overlay frame (when blocking)
+    bool blocking = false;        // Draw overlay instead of body
+    bool visible = true;          // False on blink-off frames during damage cooldown
+    int hearts = 0;               // Current remaining hearts
+    int max_hearts = 0;           // Max hearts
+};
+
+void update_player(player_data &player, const InputState &in, int arena_w, int arena_h); // Update player state (kept inside the arena)
+void load_player(player_data &player);                          // Load player resources
+void reset_player_state(player_data &player);                   // Default hearts, timers and flags (no resources)
+void capture_player_view(const player_data &player, PlayerView &out); // Fill render view
+void draw_player(const PlayerView &view);                       // Draw the player
+void draw_player_hp(const PlayerView &view);                    // Draw player's HP
 
 // Blocking helpers (moved from main)
-void update_player_block(player_data &player);            // Handle input and timers for blocking
-void draw_player_block_overlay(const player_data &player); // Draw block animation overlay
+void update_player_block(player_data &player, const InputState &in); // Handle input and timers for blocking
+int player_block_duration();                                          // Frames a block lasts (its clip's length)
+void clamp_player_anims(player_data &player);                         // Keep loaded playheads inside their clips
+void draw_player_block_overlay(const PlayerView &view);               // Draw block animation overlay
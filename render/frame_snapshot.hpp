@@ -0,0 +1,99 @@
+// Immutable per-tick render snapshot and the triple buffer that hands it from
+// the simulation thread to the window thread. The simulation fills the write
+// slot and publishes it; the renderer and the window thread's UI only ever
+// read the latest published slot, never the live world.
+#pragma once
+#include "splashkit.h"
+#include "../player/player.hpp"
+#include "../weapon/weapon_base.hpp"
+#include "../game/obstacle_map.hpp"
+#include "../game/sound_event.hpp"
+#include "../ui/shop.hpp"
+#include "world_layer.hpp"
+#include <atomic>
+#include <vector>
+
+// Coin sprite as the renderer needs it
+struct CoinView
+{
+    double x, y;  // Coin position
+    bitmap frame; // Current animation frame
+};
+
+// Everything the frame's world layer and HUD draw from
+struct FrameSnapshot
+{
+    unsigned long tick = 0;       // Simulation tick that produced this frame
+    unsigned long commands = 0;   // Window commands applied before it (SimThread::commands_done)
+    bool playing = false;         // A run is on and unpaused; nothing below is filled otherwise
+    bool quick_saved = false;     // The pause menu's last save went through
+    std::vector<SoundEvent> sounds; // Sound requests the window thread has not played yet
+
+    double camera_x = 0, camera_y = 0; // Top-left of the view, in arena coordinates
+    PlayerView player;            // Player sprite + hearts
+    std::vector<CoinView> coins;  // Active coins in view (capacity reused across ticks)
+    std::vector<Obstacle> obstacles; // Walls and crates in view
+    WorldLayer world;             // Enemies, held weapon, bullets and effects in view
+
+    // HUD values
+    int money = 0;
+    int wave = 1;
+    int remaining = 0;            // Alive enemies + still to spawn
+    bool wave_in_progress = true;
+    bool wave_cleared_prompt = false; // Enter starts the next wave
+    bool player_alive = true;
+    bool shop_open = false;
+    ShopState shop;               // Shop cards and drag state (drawn while open)
+    bool endless = false;         // Endless mode: no boss HUD, stress counters shown
+    WeaponType slots[2] = {WeaponType::None, WeaponType::None}; // Equipped weapons (shop slots)
+
+    // Entity counts and frame timing (endless mode HUD)
+    int enemies_alive = 0;
+    int bullets = 0;              // Live player bullets
+    int enemy_shots = 0;          // Live enemy projectiles
+    int coin_count = 0;           // Active coins, in view or not
+    double sim_ms = 0;            // Simulation time of this tick
+
+    // Boss HP bar
+    bool boss_bar = false;
+    double boss_ratio = 0.0;
+    bool boss_enraged = false;
+
+    // Screen effects
+    double shake_x = 0, shake_y = 0; // Camera shake offset for this frame
+    bool block_flash = false;        // Yellow cross on the player
+    bool kill_marker = false;        // Red rotated crosshair
+};
+
+// Lock-free triple buffer: one producer (simulation), one consumer (renderer).
+// Publishing never blocks and the reader always sees the newest complete frame.
+template <typename T>
+class SnapshotBuffer
+{
+public:
+    // Slot the producer fills for the next publish
+    T &write_slot() { return slots_[write_]; }
+
+    // Hand the filled slot over; the producer gets the previous back slot
+    void publish()
+    {
+        write_ = back_.exchange(write_ | kFresh) & kIndexMask;
+    }
+
+    // Newest published slot (unchanged if nothing new was published)
+    const T &read_latest()
+    {
+        if (back_.load(std::memory_order_relaxed) & kFresh)
+            read_ = back_.exchange(read_) & kIndexMask;
+        return slots_[read_];
+    }
+
+private:
+    static constexpr int kIndexMask = 0x3;
+    static constexpr int kFresh = 0x4;
+
+    T slots_[3];
+    int write_ = 0;
+    int read_ = 1;
+    std::atomic<int> back_{2};
+};
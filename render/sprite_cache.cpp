@@ -0,0 +1,110 @@
+// Sprite variant cache: the baked copies and the angle quantisation.
+#include "sprite_cache.hpp"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    const double kPi = 3.141592654;
+
+    // Monotonic stand-in for the angle of (dx, dy): 0..4 around the turn,
+    // one unit per quadrant, from a divide instead of atan2
+    double diamond_angle(double dx, double dy)
+    {
+        if (dy >= 0)
+            return dx >= 0 ? dy / (dx + dy) : 1 - dx / (dy - dx);
+        return dx < 0 ? 2 - dy / (-dx - dy) : 3 + dx / (dx - dy);
+    }
+
+    // Diamond angles of the boundaries between steps: step k covers up to
+    // bounds[k] (the last one wraps to step 0)
+    const std::vector<double> &step_bounds()
+    {
+        static const std::vector<double> bounds = [] {
+            std::vector<double> b(kRotationSteps);
+            for (int k = 0; k < kRotationSteps; ++k)
+            {
+                double a = (k + 0.5) * 2 * kPi / kRotationSteps;
+                b[k] = diamond_angle(std::cos(a), std::sin(a));
+            }
+            return b;
+        }();
+        return bounds;
+    }
+
+    // A new transparent bitmap of w x h with `src` drawn on it at (x, y)
+    bitmap bake(bitmap src, int w, int h, double x, double y, drawing_options opts)
+    {
+        static int next_id = 0;
+        bitmap out = create_bitmap("sprite_variant_" + std::to_string(next_id++), w, h);
+        clear_bitmap(out, COLOR_TRANSPARENT);
+        draw_bitmap_on_bitmap(out, src, x, y, opts);
+        return out;
+    }
+}
+
+int rotation_step(double dx, double dy)
+{
+    if (dx == 0 && dy == 0)
+        return 0;
+    const std::vector<double> &b = step_bounds();
+    int step = (int)(std::upper_bound(b.begin(), b.end(), diamond_angle(dx, dy)) - b.begin());
+    return step == kRotationSteps ? 0 : step;
+}
+
+int rotation_step_deg(double deg)
+{
+    int step = (int)std::lround(deg * kRotationSteps / 360.0) % kRotationSteps;
+    return step < 0 ? step + kRotationSteps : step;
+}
+
+bitmap SpriteVariants::flipped(bool flip_x, bool flip_y) const
+{
+    if (!src_ || (!flip_x && !flip_y))
+        return src_;
+    bitmap &slot = flips_[flip_x && flip_y ? 2 : flip_y ? 1 : 0];
+    if (!slot)
+    {
+        drawing_options opts = flip_x && flip_y ? option_flip_xy() : flip_y ? option_flip_y() : option_flip_x();
+        slot = bake(src_, bitmap_width(src_), bitmap_height(src_), 0, 0, opts);
+    }
+    return slot;
+}
+
+void SpriteVariants::draw_rotated(double x, double y, int step, drawing_options opts) const
+{
+    if (!src_)
+        return;
+    const int w = bitmap_width(src_), h = bitmap_height(src_);
+    if (w > kMaxRotatedSize || h > kMaxRotatedSize)
+    {
+        draw_bitmap(src_, x, y, option_rotate_bmp(step * 360.0 / kRotationSteps, opts));
+        return;
+    }
+
+    // Copies are square, big enough for the sprite at any angle, with the
+    // sprite's centre at theirs
+    if (rotations_.empty())
+    {
+        rotations_.assign(kRotationSteps, nullptr);
+        rotated_size_ = (int)std::ceil(std::sqrt((double)w * w + (double)h * h)) + 2;
+    }
+    const double pad_x = (rotated_size_ - w) / 2.0, pad_y = (rotated_size_ - h) / 2.0;
+    bitmap &slot = rotations_[step];
+    if (!slot)
+        slot = bake(src_, rotated_size_, rotated_size_, pad_x, pad_y,
+                    option_rotate_bmp(step * 360.0 / kRotationSteps));
+    draw_bitmap(slot, x - pad_x, y - pad_y, opts);
+}
+
+const SpriteVariants &sprite_variants(bitmap src)
+{
+    // Node-based: references stay valid as sprites are added
+    static std::unordered_map<bitmap, SpriteVariants> cache;
+    auto it = cache.find(src);
+    if (it == cache.end())
+        it = cache.emplace(src, SpriteVariants(src)).first;
+    return it->second;
+}
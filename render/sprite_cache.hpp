@@ -0,0 +1,47 @@
+// Sprite variant cache: mirrored copies and pre-rotated copies of sprites,
+// rendered once on first use and then drawn as plain blits. Bullets, shells,
+// arrows and boss shots are drawn at one of kRotationSteps angles, picked
+// from their direction without trig; facing flips are a second bitmap.
+//
+// Variants are keyed by the source bitmap and live as long as the process
+// (the sources are loaded once and never freed). Only draw code uses the
+// cache, so headless worlds never touch it.
+#pragma once
+#include "splashkit.h"
+#include <vector>
+
+const int kRotationSteps = 64;       // Angles per turn (5.6 degrees apart)
+const int kMaxRotatedSize = 64;      // Larger sprites are rotated per draw
+
+// Nearest of the kRotationSteps angles to the direction (dx, dy) (screen
+// axes, as atan2(dy, dx)); 0 for a zero vector
+int rotation_step(double dx, double dy);
+
+// Nearest step to an angle in degrees
+int rotation_step_deg(double deg);
+
+class SpriteVariants
+{
+public:
+    explicit SpriteVariants(bitmap src) : src_(src) {}
+
+    // The sprite drawn with option_flip_x / option_flip_y as asked
+    bitmap flipped(bool flip_x, bool flip_y) const;
+
+    // Draw the sprite at (x, y) as draw_bitmap with option_flip_y would when
+    // `mirrored`, else as is
+    void draw(double x, double y, bool mirrored) const { draw_bitmap(flipped(false, mirrored), x, y); }
+
+    // Draw the sprite at (x, y) rotated about its centre to angle `step`, as
+    // draw_bitmap with option_rotate_bmp would; `opts` may add a scale
+    void draw_rotated(double x, double y, int step, drawing_options opts = option_defaults()) const;
+
+private:
+    bitmap src_;
+    mutable bitmap flips_[3] = {}; // flip x, flip y, both
+    mutable std::vector<bitmap> rotations_;
+    mutable int rotated_size_ = 0; // Side of the square rotated copies
+};
+
+// The variants of `src` (created on first use; the reference stays valid)
+const SpriteVariants &sprite_variants(bitmap src);
@@ -0,0 +1,50 @@
+// World layer: drawing the captured enemies, sprites and effects.
+#include "world_layer.hpp"
+#include "sprite_cache.hpp"
+
+static void draw_sprite(const SpriteView &s)
+{
+    const SpriteVariants &variants = sprite_variants(s.image);
+    if (s.step >= 0)
+    {
+        variants.draw_rotated(s.x, s.y, s.step, s.scale != 1 ? option_scale_bmp(s.scale, s.scale) : option_defaults());
+        return;
+    }
+    bitmap img = variants.flipped(s.flip_x, s.flip_y);
+    if (s.angle != 0)
+        draw_bitmap(img, s.x, s.y, option_rotate_bmp(s.angle));
+    else
+        draw_bitmap(img, s.x, s.y);
+}
+
+void draw_world_layer(const WorldLayer &layer)
+{
+    for (const EnemyView &e : layer.enemies)
+    {
+        if (e.frame)
+            sprite_variants(e.frame).draw(e.x, e.y, e.mirrored);
+        else
+            fill_rectangle(e.fallback, e.x, e.y, e.w, e.h);
+
+        if (e.hp_ratio >= 0)
+        {
+            fill_rectangle(COLOR_GREEN, e.x, e.y - 10, e.w * e.hp_ratio, 5); // Green fill (current health)
+            draw_rectangle(COLOR_BLACK, e.x, e.y - 10, e.w, 5);              // Black border
+        }
+    }
+
+    for (const SpriteView &s : layer.sprites)
+        if (s.image)
+            draw_sprite(s);
+
+    for (const DotView &d : layer.dots)
+        fill_circle(d.colour, d.x, d.y, d.radius);
+
+    for (const LineView &l : layer.lines)
+    {
+        if (l.width > 1)
+            draw_line(l.colour, l.x0, l.y0, l.x1, l.y1, option_line_width(l.width));
+        else
+            draw_line(l.colour, l.x0, l.y0, l.x1, l.y1);
+    }
+}
@@ -0,0 +1,66 @@
+// World layer of a render snapshot: what the enemies, weapons and their
+// effects look like this tick, as plain draw data. Entities fill it from the
+// simulation thread (their capture functions); the renderer draws it from the
+// published snapshot without touching any live entity.
+#pragma once
+#include "splashkit.h"
+#include <vector>
+
+// A sprite: flipped and/or rotated copies come from the sprite cache
+struct SpriteView
+{
+    bitmap image = nullptr;
+    double x = 0, y = 0;
+    bool flip_x = false, flip_y = false; // Mirrored copy (option_flip_x / option_flip_y)
+    int step = -1;                       // Pre-rotated copy at this rotation step; -1 for none
+    double angle = 0;                    // Free rotation in degrees (when step is -1)
+    double scale = 1;
+};
+
+// A coloured line: sparks, lasers, telegraphs
+struct LineView
+{
+    color colour;
+    double x0, y0, x1, y1;
+    int width = 1;
+};
+
+// A filled circle (sprites missing their bitmap)
+struct DotView
+{
+    color colour;
+    double x, y, radius;
+};
+
+// An enemy body with its health bar
+struct EnemyView
+{
+    double x, y, w, h;       // Body box
+    bitmap frame = nullptr;  // Pose sprite; null draws a box of `fallback`
+                             // (COLOR_TRANSPARENT: nothing)
+    bool mirrored = false;   // Drawn as SpriteVariants::draw mirrors
+    double hp_ratio = -1;    // Health bar fill (0..1); negative for none
+    color fallback;
+};
+
+// Everything entities contribute to the world layer. Drawn enemies first,
+// then sprites, dots and lines, each in capture order. The vectors keep their
+// capacity across ticks.
+struct WorldLayer
+{
+    std::vector<EnemyView> enemies;
+    std::vector<SpriteView> sprites;
+    std::vector<DotView> dots;
+    std::vector<LineView> lines;
+
+    void clear()
+    {
+        enemies.clear();
+        sprites.clear();
+        dots.clear();
+        lines.clear();
+    }
+};
+
+// Draw `layer` under the current camera
+void draw_world_layer(const WorldLayer &layer);
@@ -1,67 +1,375 @@
 #include "save.hpp"
+#include <array>
 #include <fstream>
 #include <filesystem>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
+// File layout (all integers little-endian):
+//   header  "SHSV" | u16 format | u16 reserved | u32 payload size | u32 CRC-32 of payload
+//   payload sequence of records: u16 tag | u16 size | size bytes
+// Readers skip tags they don't know and keep defaults for tags that are
+// missing, so older and newer builds can read each other's saves. What a
+// field meant in an older layout is then fixed up by migrate(), one layout
+// version at a time.
+// The quick save uses the same header with magic "SHQS" around a raw world
+// snapshot blob.
 static const char* kSaveRelPath = "save/save.dat";
+static const char* kQuickRelPath = "save/quick.dat";
+static const char kMagic[4] = {'S', 'H', 'S', 'V'};
+static const char kQuickMagic[4] = {'S', 'H', 'Q', 'S'};
+static const uint16_t kFormat = 1;
+static const size_t kHeaderSize = 16;
+
+enum SaveTag : uint16_t {
+    TAG_VERSION  = 1, // i32 SaveData layout version
+    TAG_MONEY    = 2, // i32
+    TAG_WAVE     = 3, // i32
+    TAG_SLOTS    = 4, // i32 x2
+    TAG_CURRENT  = 5, // i32
+    TAG_UNLOCKED = 6, // u8 x n (n may differ between versions)
+};
 
 std::string save_file_path() {
     return std::string(kSaveRelPath);
 }
 
-bool save_exists() {
-    return std::filesystem::exists(save_file_path());
+// ---- CRC-32 (IEEE, reflected) ----
+// The table is built by a static initialiser, which runs once even when the
+// background saver and the main thread get here together
+static uint32_t crc32(const uint8_t *data, size_t n) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; ++i) c = table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
 }
 
-bool save_game(const SaveData &data) {
-    std::ofstream ofs(save_file_path(), std::ios::trunc | std::ios::out);
-    if (!ofs.is_open()) return false;
-    ofs << "version " << data.version << "\n";
-    ofs << "money " << data.money << "\n";
-    ofs << "wave " << data.wave << "\n";
-    ofs << "slot0 " << data.slot_types[0] << "\n";
-    ofs << "slot1 " << data.slot_types[1] << "\n";
-    ofs << "current " << data.current_slot << "\n";
-    ofs << "unlocked ";
-    for (int i = 0; i < 6; ++i) {
-        ofs << (data.unlocked[i] ? 1 : 0);
-        if (i < 5) ofs << ' ';
+// ---- little-endian helpers ----
+static void put_u16(std::vector<uint8_t> &b, uint16_t v) {
+    b.push_back(v & 0xFF); b.push_back(v >> 8);
+}
+static void put_u32(std::vector<uint8_t> &b, uint32_t v) {
+    for (int i = 0; i < 4; ++i) b.push_back((v >> (8 * i)) & 0xFF);
+}
+static uint16_t get_u16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_record(std::vector<uint8_t> &b, uint16_t tag, const std::vector<uint8_t> &body) {
+    put_u16(b, tag); put_u16(b, (uint16_t)body.size());
+    b.insert(b.end(), body.begin(), body.end());
+}
+static void put_i32_record(std::vector<uint8_t> &b, uint16_t tag, std::initializer_list<int32_t> vals) {
+    std::vector<uint8_t> body;
+    for (int32_t v : vals) put_u32(body, (uint32_t)v);
+    put_record(b, tag, body);
+}
+
+// Header + payload
+static std::vector<uint8_t> wrap(const char magic[4], const std::vector<uint8_t> &payload) {
+    std::vector<uint8_t> file(magic, magic + 4);
+    put_u16(file, kFormat);
+    put_u16(file, 0);
+    put_u32(file, (uint32_t)payload.size());
+    put_u32(file, crc32(payload.data(), payload.size()));
+    file.insert(file.end(), payload.begin(), payload.end());
+    return file;
+}
+
+// Validate the header and CRC; on success `payload`/`size` point into `file`
+static bool unwrap(const std::vector<uint8_t> &file, const char magic[4], const uint8_t *&payload, uint32_t &size) {
+    if (file.size() < kHeaderSize || std::memcmp(file.data(), magic, 4) != 0) return false;
+    size = get_u32(&file[8]);
+    if (file.size() - kHeaderSize < size) return false; // truncated
+    payload = file.data() + kHeaderSize;
+    return crc32(payload, size) == get_u32(&file[12]); // corrupted otherwise
+}
+
+// Upgrade `d`, read as layout d.version, to kSaveVersion one step at a time.
+// A save from a newer build keeps its version: the fields this build knows
+// were read as they are and the rest were skipped.
+//   v1  old text save.dat: 6 unlock flags, shop of AK, Pistol, Shotgun, AWP
+//   v2  binary: 6 unlock flags (Gatling and Kleber cards added)
+//   v3  8 unlock flags (Seeker card added)
+static void migrate(SaveData &d) {
+    if (d.version < 2) {
+        // Flags 4 and 5 had no card behind them in v1; they now unlock the
+        // Gatling and Kleber, which a v1 player never bought
+        for (int i = 4; i < kSaveUnlockFlags; ++i) d.unlocked[i] = false;
+        d.version = 2;
     }
-    ofs << "\n";
-    return true;
+    if (d.version < 3) {
+        // Cards past the sixth did not exist: they start locked
+        for (int i = 6; i < kSaveUnlockFlags; ++i) d.unlocked[i] = false;
+        d.version = 3;
+    }
+}
+
+static std::vector<uint8_t> encode(const SaveData &d) {
+    std::vector<uint8_t> payload;
+    put_i32_record(payload, TAG_VERSION, {kSaveVersion});
+    put_i32_record(payload, TAG_MONEY, {d.money});
+    put_i32_record(payload, TAG_WAVE, {d.wave});
+    put_i32_record(payload, TAG_SLOTS, {d.slot_types[0], d.slot_types[1]});
+    put_i32_record(payload, TAG_CURRENT, {d.current_slot});
+    std::vector<uint8_t> flags;
+    for (bool u : d.unlocked) flags.push_back(u ? 1 : 0);
+    put_record(payload, TAG_UNLOCKED, flags);
+    return wrap(kMagic, payload);
 }
 
-static bool read_token(std::istream &is, std::string &key) {
-    if (!(is >> key)) return false;
+static bool decode(const std::vector<uint8_t> &file, SaveData &out) {
+    const uint8_t *p;
+    uint32_t size;
+    if (!unwrap(file, kMagic, p, size)) return false;
+
+    SaveData d; // defaults fill anything the file doesn't carry
+    d.version = 2; // the first binary layout
+    const uint8_t *end = p + size;
+    while (end - p >= 4) {
+        uint16_t tag = get_u16(p), len = get_u16(p + 2);
+        p += 4;
+        if (end - p < len) return false;
+        auto i32 = [&](int k) { return (int32_t)get_u32(p + 4 * k); };
+        switch (tag) {
+        case TAG_VERSION:  if (len >= 4) d.version = i32(0); break;
+        case TAG_MONEY:    if (len >= 4) d.money = i32(0); break;
+        case TAG_WAVE:     if (len >= 4) d.wave = i32(0); break;
+        case TAG_SLOTS:    if (len >= 8) { d.slot_types[0] = i32(0); d.slot_types[1] = i32(1); } break;
+        case TAG_CURRENT:  if (len >= 4) d.current_slot = i32(0); break;
+        case TAG_UNLOCKED:
+            for (int i = 0; i < kSaveUnlockFlags && i < len; ++i) d.unlocked[i] = p[i] != 0;
+            break;
+        default: break; // newer field: skip
+        }
+        p += len;
+    }
+    migrate(d);
+    out = d;
     return true;
 }
 
-bool load_game(SaveData &out) {
-    std::ifstream ifs(save_file_path());
-    if (!ifs.is_open()) return false;
+// Old whitespace text format ("version 1\nmoney 269\n...")
+static bool import_text_save(const std::vector<uint8_t> &file, SaveData &out) {
+    static const char kLegacyKey[] = "version";
+    if (file.size() < sizeof(kLegacyKey) - 1 || std::memcmp(file.data(), kLegacyKey, sizeof(kLegacyKey) - 1) != 0)
+        return false;
+    std::string text(file.begin(), file.end());
+    std::istringstream ifs(text);
+    SaveData d;
+    d.version = 1; // files without the key predate it
     std::string key;
-    while (read_token(ifs, key)) {
-        if (key == "version") ifs >> out.version;
-        else if (key == "money") ifs >> out.money;
-        else if (key == "wave") ifs >> out.wave;
-        else if (key == "slot0") ifs >> out.slot_types[0];
-        else if (key == "slot1") ifs >> out.slot_types[1];
-        else if (key == "current") ifs >> out.current_slot;
+    while (ifs >> key) {
+        if (key == "version") ifs >> d.version;
+        else if (key == "money") ifs >> d.money;
+        else if (key == "wave") ifs >> d.wave;
+        else if (key == "slot0") ifs >> d.slot_types[0];
+        else if (key == "slot1") ifs >> d.slot_types[1];
+        else if (key == "current") ifs >> d.current_slot;
         else if (key == "unlocked") {
             for (int i = 0; i < 6; ++i) {
-                int v = 0; ifs >> v; out.unlocked[i] = (v != 0);
+                int v = 0; ifs >> v; d.unlocked[i] = (v != 0);
             }
         } else {
-            // skip unknowns
             std::string dummy; std::getline(ifs, dummy);
         }
     }
+    migrate(d);
+    out = d;
     return true;
 }
 
+// ---- atomic file replace ----
+#ifndef _WIN32
+// fsync the directory holding `path`, so a rename into it survives a crash
+static bool sync_parent_dir(const std::string &path) {
+    std::string dir = std::filesystem::path(path).parent_path().string();
+    int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+#endif
+
+static bool write_file_atomic(const std::string &path, const std::vector<uint8_t> &bytes) {
+    std::string tmp = path + ".tmp";
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    FILE *f = std::fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    ok = ok && std::fflush(f) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(f)) == 0;
+#else
+    ok = ok && fsync(fileno(f)) == 0;
+#endif
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    ok = MoveFileExA(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+#ifndef _WIN32
+    return sync_parent_dir(path); // the new directory entry, not just the data
+#else
+    return true;
+#endif
+}
+
+// ---- background saver ----
+namespace {
+struct Saver {
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::thread worker;
+    SaveData pending;
+    bool has_pending = false;
+    bool busy = false;
+    bool quit = false;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mtx);
+        for (;;) {
+            cv.wait(lock, [&] { return quit || has_pending; });
+            if (!has_pending) return; // quit with nothing left to write
+            SaveData d = pending;
+            has_pending = false;
+            busy = true;
+            lock.unlock();
+            save_game(d);
+            lock.lock();
+            busy = false;
+            cv.notify_all();
+        }
+    }
+
+    void wait_idle(std::unique_lock<std::mutex> &lock) {
+        cv.wait(lock, [&] { return !has_pending && !busy; });
+    }
+
+    ~Saver() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quit = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join(); // flushes the last queued save
+    }
+};
+
+Saver &saver() {
+    static Saver s;
+    return s;
+}
+}
+
+bool save_exists() {
+    wait_for_saves();
+    return std::filesystem::exists(save_file_path());
+}
+
+bool save_game(const SaveData &data) {
+    return write_file_atomic(save_file_path(), encode(data));
+}
+
+void save_game_async(const SaveData &data) {
+    Saver &s = saver();
+    std::lock_guard<std::mutex> lock(s.mtx);
+    if (!s.worker.joinable())
+        s.worker = std::thread(&Saver::run, &s);
+    s.pending = data;
+    s.has_pending = true;
+    s.cv.notify_all();
+}
+
+void wait_for_saves() {
+    Saver &s = saver();
+    std::unique_lock<std::mutex> lock(s.mtx);
+    s.wait_idle(lock);
+}
+
+static bool read_file(const std::string &path, std::vector<uint8_t> &bytes) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) return false;
+    bytes.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool load_game(SaveData &out) {
+    wait_for_saves();
+    std::vector<uint8_t> bytes;
+    if (!read_file(save_file_path(), bytes)) return false;
+    if (decode(bytes, out)) return true;
+    return import_text_save(bytes, out); // next save_game rewrites it as binary
+}
+
 bool delete_save() {
-    if (!save_exists()) return true;
+    {
+        Saver &s = saver();
+        std::unique_lock<std::mutex> lock(s.mtx);
+        s.has_pending = false; // a queued save must not resurrect the file
+        s.wait_idle(lock);
+    }
     std::error_code ec;
     std::filesystem::remove(save_file_path(), ec);
-    return !ec;
+    if (ec) return false;
+    return delete_quick_save();
 }
 
+// ---- quick save ----
+bool quick_save_exists() {
+    return std::filesystem::exists(kQuickRelPath);
+}
+
+bool save_quick(const std::vector<uint8_t> &blob) {
+    return write_file_atomic(kQuickRelPath, wrap(kQuickMagic, blob));
+}
+
+bool load_quick(std::vector<uint8_t> &blob) {
+    std::vector<uint8_t> bytes;
+    if (!read_file(kQuickRelPath, bytes)) return false;
+    const uint8_t *p;
+    uint32_t size;
+    if (!unwrap(bytes, kQuickMagic, p, size)) return false;
+    blob.assign(p, p + size);
+    return true;
+}
+
+bool delete_quick_save() {
+    std::error_code ec;
+    std::filesystem::remove(kQuickRelPath, ec);
+    return !ec;
+}
@@ -2,21 +2,48 @@
 #include <vector>
 #include <string>
 
+// Current SaveData layout version (bump when fields are added or change meaning)
+const int kSaveVersion = 3;
+
+// Shop unlock flags kept in a save (weapons past this many start locked)
+const int kSaveUnlockFlags = 8;
+
 struct SaveData {
-    int version = 1;
+    int version = kSaveVersion; // Layout version the data was read as / written with
     int money = 0;
     int wave = 1;
-    // weapon types for two slots: -1 if empty, else 0..5
+    // weapon types for two slots: -1 if empty, else a WeaponType id
     int slot_types[2] = {-1, -1};
     int current_slot = 0; // 0 or 1
-    // shop unlock flags (first 4 used: Pistol, AK, Shotgun, AWP)
-    bool unlocked[6] = {true, true, false, false, false, false};
+    // shop unlock flags, in shop card order (weapons.def block order)
+    bool unlocked[kSaveUnlockFlags] = {true, true};
 };
 
 // Path to save file (relative to project root)
 std::string save_file_path();
 
 bool save_exists();
+
+// Write synchronously: binary, CRC-checked, via temp file + fsync + rename,
+// so a crash leaves either the old or the new save, never a torn one
 bool save_game(const SaveData &data);
+
+// Queue a save for the background saver thread and return immediately.
+// Only the newest pending save is kept; it is flushed before exit.
+void save_game_async(const SaveData &data);
+
+// Block until queued saves have reached the disk
+void wait_for_saves();
+
+// Reads the binary format; also imports the old text save.dat
 bool load_game(SaveData &out);
+
+// Drops any queued save, then removes the file (and the quick save)
 bool delete_save();
+
+// Quick save: an opaque mid-wave world snapshot (see game/snapshot.hpp),
+// stored CRC-checked and atomically next to the wave-start save
+bool quick_save_exists();
+bool save_quick(const std::vector<uint8_t> &blob);
+bool load_quick(std::vector<uint8_t> &blob);
+bool delete_quick_save();
@@ -0,0 +1,201 @@
+// Headless batch simulator: plays complete seeded games (every wave of
+// enemy/waves.def, ending with the boss) with the autopilot, one world per
+// worker thread, and writes one CSV row per seed. Used as a throughput
+// benchmark and to catch balance regressions in the wave schedule and the
+// Boss timings. The endless modes play generated waves instead; "stress"
+// starts at a late endless wave and keeps the player alive, so the run
+// measures the tick rate with the horde at its alive cap (thousands).
+//
+// Build and run from the repo root (the game/, enemy/ and weapon/ .def files are read at startup),
+// with the same toolchain as the game, e.g.:
+//   g++ -std=c++17 -O2 -pthread -I. tools/batch_sim.cpp game/game_world.cpp
+//       game/anim_clip.cpp game/enemy_index.cpp game/flow_field.cpp game/crowd_grid.cpp game/obstacle_map.cpp game/autopilot.cpp
+//       player/player.cpp ui/shop.cpp weapon/*.cpp enemy/wave_schedule.cpp enemy/enemy_archetype.cpp enemy/sprite_mask.cpp
+//       enemy/slime/slime.cpp enemy/hilichurl/*.cpp enemy/boss/boss.cpp render/sprite_cache.cpp
+//       -lSplashKit -o batch_sim
+//
+// Usage: batch_sim [runs=256] [threads=cores] [first_seed=1] [out=batch_sim.csv]
+//                  [mode=story|endless|stress]
+#include "../game/game_world.hpp"
+#include "../game/autopilot.hpp"
+#include "../ui/shop.hpp"
+#include "../weapon/weapon_registry.hpp"
+#include "../enemy/wave_schedule.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const long max_ticks = 120L * 60 * 30; // 30 minutes of game time at 120 FPS
+
+    const long stress_ticks = 120L * 60 * 2; // Stress runs: 2 minutes
+    const int stress_wave = 16;              // First wave of a stress run (max_alive at its cap)
+
+    enum class Mode { Story, Endless, Stress };
+
+    struct RunResult
+    {
+        uint64_t seed = 0;
+        int wave_reached = 0;
+        bool boss_killed = false;
+        long boss_ticks = -1;    // Ticks from boss wave start to its death (-1: not killed)
+        long ticks = 0;          // Ticks simulated in total
+        int hits_taken = 0;      // Hearts lost
+        long coins_earned = 0;   // Money picked up (before shop spending)
+        double ticks_per_sec = 0;
+        int peak_enemies = 0;    // Most enemies alive at once
+    };
+
+    RunResult run_one(uint64_t seed, Mode mode)
+    {
+        RunResult r;
+        r.seed = seed;
+
+        GameWorld world;
+        world.headless = true;
+        world.rng.seed(seed);
+        load_world_assets(world);
+        start_new_game(world, mode != Mode::Story);
+        if (mode == Mode::Stress)
+            world.wave = stress_wave;
+
+        ShopState shop;
+        init_shop_items(shop);
+        AutopilotState bot;
+
+        long boss_start = -1;
+        auto t0 = std::chrono::steady_clock::now();
+
+        const long ticks = mode == Mode::Stress ? stress_ticks : max_ticks;
+        for (; r.ticks < ticks; ++r.ticks)
+        {
+            if (!world.player.alive)
+                break;
+
+            if (!world.wave_in_progress)
+            {
+                if (final_wave(world))
+                {
+                    r.boss_killed = true;
+                    r.boss_ticks = r.ticks - boss_start;
+                    break;
+                }
+                autopilot_intermission(world, shop);
+                if (boss_wave(world))
+                    boss_start = r.ticks;
+            }
+
+            InputState in = autopilot_input(world, bot);
+            int hearts_before = world.player.hearts;
+            update_world(world, in);
+            if (world.player.hearts < hearts_before)
+                r.hits_taken += hearts_before - world.player.hearts;
+            world.player.just_got_hit = false;
+            if (mode == Mode::Stress)
+            {
+                world.player.hearts = world.player.max_hearts;
+                world.player.alive = true;
+            }
+            r.peak_enemies = std::max(r.peak_enemies, world.spawn.alive);
+
+            int money_before = world.money;
+            update_coins(world);
+            r.coins_earned += world.money - money_before;
+
+            if (world.block_flash_timer > 0) world.block_flash_timer--;
+            if (world.kill_marker_timer > 0) world.kill_marker_timer--;
+        }
+
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        r.wave_reached = world.wave;
+        r.ticks_per_sec = secs > 0 ? r.ticks / secs : 0;
+        return r;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int runs = argc > 1 ? std::atoi(argv[1]) : 256;
+    int threads = argc > 2 ? std::atoi(argv[2]) : (int)std::thread::hardware_concurrency();
+    uint64_t first_seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1;
+    std::string out_path = argc > 4 ? argv[4] : "batch_sim.csv";
+    std::string mode_name = argc > 5 ? argv[5] : "story";
+    Mode mode = mode_name == "endless" ? Mode::Endless : mode_name == "stress" ? Mode::Stress : Mode::Story;
+    if (mode == Mode::Story && mode_name != "story")
+    {
+        std::fprintf(stderr, "batch_sim: unknown mode %s (story, endless or stress)\n", mode_name.c_str());
+        return 1;
+    }
+    if (runs < 1) runs = 1;
+    if (threads < 1) threads = 1;
+    if (!weapon_defs_error().empty())
+    {
+        std::fprintf(stderr, "weapon definitions: %s\n", weapon_defs_error().c_str());
+        return 1;
+    }
+    if (!enemy_defs_error().empty())
+    {
+        std::fprintf(stderr, "enemy definitions: %s\n", enemy_defs_error().c_str());
+        return 1;
+    }
+    if (!wave_defs_error().empty())
+    {
+        std::fprintf(stderr, "wave definitions: %s\n", wave_defs_error().c_str());
+        return 1;
+    }
+    if (!obstacle_defs_error().empty())
+    {
+        std::fprintf(stderr, "obstacle layout: %s\n", obstacle_defs_error().c_str());
+        return 1;
+    }
+    if (!mask_defs_error().empty())
+    {
+        std::fprintf(stderr, "sprite masks: %s\n", mask_defs_error().c_str());
+        return 1;
+    }
+
+    std::vector<RunResult> results(runs);
+    std::atomic<int> next{0};
+    auto t0 = std::chrono::steady_clock::now();
+
+    // One world per worker; workers pull seeds until the batch is done
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back([&] {
+            for (int i = next++; i < runs; i = next++)
+                results[i] = run_one(first_seed + i, mode);
+        });
+    for (auto &th : pool)
+        th.join();
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    FILE *f = std::fopen(out_path.c_str(), "w");
+    if (!f)
+    {
+        std::fprintf(stderr, "batch_sim: cannot write %s\n", out_path.c_str());
+        return 1;
+    }
+    std::fprintf(f, "seed,wave_reached,boss_killed,boss_ticks,ticks,hits_taken,coins_earned,ticks_per_sec,peak_enemies\n");
+    long total_ticks = 0;
+    int kills = 0;
+    for (const auto &r : results)
+    {
+        std::fprintf(f, "%llu,%d,%d,%ld,%ld,%d,%ld,%.0f,%d\n",
+                     (unsigned long long)r.seed, r.wave_reached, r.boss_killed ? 1 : 0,
+                     r.boss_ticks, r.ticks, r.hits_taken, r.coins_earned, r.ticks_per_sec, r.peak_enemies);
+        total_ticks += r.ticks;
+        if (r.boss_killed) kills++;
+    }
+    std::fclose(f);
+
+    std::printf("%d runs on %d threads in %.2fs: %.0f ticks/sec total, boss killed in %d/%d -> %s\n",
+                runs, threads, secs, secs > 0 ? total_ticks / secs : 0.0, kills, runs, out_path.c_str());
+    return 0;
+}
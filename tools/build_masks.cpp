@@ -0,0 +1,76 @@
+// Sprite mask builder: writes enemy/masks.def from the enemy sprites, one
+// mask per pose of enemies.def (the sprites of the first set), one bit per
+// pixel set where the pixel is opaque (alpha >= 128). A pose opaque
+// everywhere is written as "full" and collided by its boxes alone. Rerun it
+// whenever a sprite or the sprite list of enemies.def changes.
+//
+// Build and run from the directory the game runs from (the sprite paths in
+// enemies.def are relative to it), e.g.:
+//   g++ -std=c++17 -O2 -I. tools/build_masks.cpp enemy/enemy_archetype.cpp
+//       -lSplashKit -o build_masks
+//
+// Usage: build_masks [out=enemy/masks.def]
+#include "splashkit.h"
+#include "../enemy/enemy_archetype.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    const char *out_path = argc > 1 ? argv[1] : "enemy/masks.def";
+    if (!enemy_defs_error().empty())
+    {
+        fprintf(stderr, "enemy definitions: %s\n", enemy_defs_error().c_str());
+        return 1;
+    }
+    FILE *out = fopen(out_path, "w");
+    if (!out)
+    {
+        fprintf(stderr, "cannot write %s\n", out_path);
+        return 1;
+    }
+
+    fprintf(out, "# Sprite collision masks, generated from the enemy sprites by tools/build_masks:\n"
+                 "# do not edit by hand, rerun the tool when a sprite or enemies.def changes.\n"
+                 "#\n"
+                 "#   mask <enemy> <pose> <w> <h>  followed by h rows of ceil(w / 64) hex words;\n"
+                 "#                                bit i of word k is pixel 64k + i of the row,\n"
+                 "#                                set where the pixel is opaque (alpha >= 128)\n"
+                 "#   mask <enemy> <pose> <w> <h> full\n"
+                 "#                                every pixel is opaque: the boxes are exact\n"
+                 "#\n"
+                 "# Poses are those of enemies.def (the sprites of the first set).\n");
+
+    for (int k = 0; k < kEnemyKinds; ++k)
+    {
+        const EnemyKind kind = (EnemyKind)k;
+        load_enemy_sprites(kind);
+        const EnemyArchetype &a = enemy_archetype(kind);
+        for (int pose = 0; pose < (int)a.frames.size(); ++pose)
+        {
+            bitmap bmp = a.sprite(pose);
+            const int w = bitmap_width(bmp), h = bitmap_height(bmp), words = (w + 63) / 64;
+            std::vector<uint64_t> bits((size_t)words * h, 0);
+            bool full = true;
+            for (int y = 0; y < h; ++y)
+                for (int x = 0; x < w; ++x)
+                {
+                    if (alpha_of(get_pixel(bmp, x, y)) >= 128)
+                        bits[(size_t)y * words + x / 64] |= uint64_t(1) << (x % 64);
+                    else
+                        full = false;
+                }
+
+            fprintf(out, "\nmask %s %d %d %d%s\n", a.name.c_str(), pose, w, h, full ? " full" : "");
+            if (full)
+                continue;
+            for (int y = 0; y < h; ++y)
+                for (int i = 0; i < words; ++i)
+                    fprintf(out, "%016llx%c", (unsigned long long)bits[(size_t)y * words + i], i + 1 < words ? ' ' : '\n');
+        }
+    }
+    fclose(out);
+    printf("wrote %s\n", out_path);
+    return 0;
+}
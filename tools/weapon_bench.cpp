@@ -0,0 +1,100 @@
+// Weapon engine benchmark: runs each weapon of weapons.def under sustained
+// fire and reports the time per weapon update and the bullets left alive. A
+// large arena, with a view just as large so the active region does not cull
+// them, keeps bullets alive for longer, so the bullet-integration loop
+// dominates the timing.
+//
+// Build and run from the repo root, e.g.:
+//   g++ -std=c++17 -O2 -I. tools/weapon_bench.cpp weapon/firearm.cpp
+//       weapon/weapon_registry.cpp game/enemy_index.cpp game/obstacle_map.cpp player/player.cpp
+//       enemy/enemy_archetype.cpp enemy/sprite_mask.cpp game/anim_clip.cpp render/sprite_cache.cpp
+//       -lSplashKit -o weapon_bench
+//
+// Usage: weapon_bench [ticks=200000] [arena=20000]
+
+#include "../game/game_world.hpp"
+#include "../weapon/weapon_registry.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // Fire continuously while sweeping the aim around the player; inputs are
+    // precomputed so the timing covers only the weapon
+    std::vector<InputState> make_inputs(const GameWorld &world)
+    {
+        std::vector<InputState> inputs(1024);
+        for (size_t t = 0; t < inputs.size(); ++t)
+        {
+            InputState &in = inputs[t];
+            in.fire_down = true;
+            in.fire_clicked = true;
+            double a = t * (2 * 3.141592654 / inputs.size());
+            in.aim_x = world.player.player_x + cos(a) * 300;
+            in.aim_y = world.player.player_y + sin(a) * 300;
+        }
+        return inputs;
+    }
+
+    struct Result
+    {
+        double ns_per_update = 0;
+        size_t live_bullets = 0;
+    };
+
+    // Best of a few repeats, each from a fresh weapon
+    Result run(WeaponType type, GameWorld &world, const std::vector<InputState> &inputs, long ticks)
+    {
+        Result r;
+        for (int rep = 0; rep < 5; ++rep)
+        {
+            auto weapon = create_weapon(type);
+            world.rng.seed(1); // same spread rolls every repeat
+            auto t0 = std::chrono::steady_clock::now();
+            for (long t = 0; t < ticks; ++t)
+                weapon->update(world, inputs[t % inputs.size()]);
+            auto t1 = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / ticks;
+            if (rep == 0 || ns < r.ns_per_update)
+                r.ns_per_update = ns;
+            if (rep == 0)
+                for (const auto &b : weapon->bullets())
+                    r.live_bullets += b.active;
+        }
+        return r;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    long ticks = argc > 1 ? std::atol(argv[1]) : 200000;
+    int arena = argc > 2 ? std::atoi(argv[2]) : 20000;
+    if (ticks < 1) ticks = 1;
+    if (!weapon_defs_error().empty())
+    {
+        std::fprintf(stderr, "weapon definitions: %s\n", weapon_defs_error().c_str());
+        return 1;
+    }
+
+    static const ObstacleMap open_arena; // Nothing in the bullets' way
+    GameWorld world;
+    world.headless = true;
+    world.obstacles = &open_arena;
+    world.arena_w = world.arena_h = arena;
+    world.view_w = world.view_h = arena; // Bullets fly until they leave the arena
+    world.player.player_x = arena / 2.0;
+    world.player.player_y = arena / 2.0;
+
+    std::vector<InputState> inputs = make_inputs(world);
+    std::printf("%-10s %12s %8s\n", "weapon", "ns/update", "bullets");
+    for (WeaponType type : weapon_types())
+    {
+        Result r = run(type, world, inputs, ticks);
+        std::printf("%-10s %12.1f %8zu\n", weapon_info(type).name.c_str(), r.ns_per_update, r.live_bullets);
+    }
+    return 0;
+}
@@ -8,7 +8,7 @@ void init_menu(MenuState &m, bool has_save) {
 }
 
 MenuAction update_menu(MenuState &m) {
-    int max_index = m.has_save ? 3 : 2; // 0..2 (New, Continue?, Quit)
+    int max_index = m.has_save ? 4 : 3; // 0..3 (New, Endless, Continue?, Quit)
     // input
     if (key_typed(DOWN_KEY) || key_typed(S_KEY)) {
         m.selected = (m.selected + 1) % max_index;
@@ -18,11 +18,12 @@ MenuAction update_menu(MenuState &m) {
     }
     if (key_typed(RETURN_KEY) || key_typed(SPACE_KEY)) {
         if (m.selected == 0) return MenuAction::NewGame;
+        if (m.selected == 1) return MenuAction::Endless;
         if (m.has_save) {
-            if (m.selected == 1) return MenuAction::Continue;
-            if (m.selected == 2) return MenuAction::Quit;
+            if (m.selected == 2) return MenuAction::Continue;
+            if (m.selected == 3) return MenuAction::Quit;
         } else {
-            if (m.selected == 1) return MenuAction::Quit;
+            if (m.selected == 2) return MenuAction::Quit;
         }
     }
     return MenuAction::None;
@@ -40,13 +41,15 @@ void draw_menu(const MenuState &m, int screen_w, int screen_h) {
     // Menu options
     color c0 = (m.selected == 0) ? COLOR_YELLOW : COLOR_WHITE;
     draw_text("New Game", c0, "arial", 36, x, y);
-    int idx = 1;
+    color cE = (m.selected == 1) ? COLOR_YELLOW : COLOR_WHITE;
+    draw_text("Endless", cE, "arial", 36, x, y + line_gap);
+    int idx = 2;
     if (m.has_save) {
-        color c1 = (m.selected == 1) ? COLOR_YELLOW : COLOR_WHITE;
+        color c1 = (m.selected == 2) ? COLOR_YELLOW : COLOR_WHITE;
         draw_text("Continue", c1, "arial", 36, x, y + line_gap * idx);
         idx++;
     }
-    color cQ = (m.selected == (m.has_save ? 2 : 1)) ? COLOR_YELLOW : COLOR_WHITE;
+    color cQ = (m.selected == (m.has_save ? 3 : 2)) ? COLOR_YELLOW : COLOR_WHITE;
     draw_text("Quit", cQ, "arial", 36, x, y + line_gap * idx);
 
     draw_text("Use W/S or Up/Down, Enter to select", COLOR_WHITE, "arial", 22, x, y + line_gap * (idx + 2));
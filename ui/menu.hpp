@@ -10,6 +10,7 @@ struct MenuState {
 enum class MenuAction {
     None,
     NewGame,
+    Endless,
     Continue,
     Quit
 };
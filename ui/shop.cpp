@@ -1,55 +1,104 @@
 // Shop UI implementation
 #include "shop.hpp"
 
-static void preload_images(const ShopState &s)
+namespace
 {
-    for (auto &it : s.items) load_bitmap(it.image_key, it.image_path);
+    // Card grid: 4 columns, so two rows (8 cards, the saved unlock flags)
+    // end above the equip slots
+    const double card_start_x = 240, card_start_y = 260;
+    const double card_gap_x = 120, card_gap_y = 24;
+    const double card_w = 170, card_h = 140;
+    const int card_cols = 4;
+
+    // Equip slots, below the card grid
+    const double slot_y = 620, slot_w = 144, slot_h = 120;
+    const double slot_x1 = 380, slot_x2 = 760;
+
+    // Top-left corner of card i
+    void card_pos(int i, double &cx, double &cy)
+    {
+        cx = card_start_x + (i % card_cols) * (card_w + card_gap_x);
+        cy = card_start_y + (i / card_cols) * (card_h + card_gap_y);
+    }
 }
 
-void init_shop(ShopState &s)
+void init_shop_items(ShopState &s)
 {
-    s.items = {
-        {"AK-47","weapon_ak_img","../image/weapon/weapon_AK-47.png",0,"","",1,true},
-        {"Pistol","weapon_img_0","../image/weapon/DEagle_0.png",0,"","",0,true},
-        {"Shotgun","shotgun_img","../image/weapon/Shotgun.png",80,"","",2,false},
-        {"AWP","awp_img","../image/weapon/AWP.png",120,"","",3,false}
-    };
+    // One card per weapon, in weapons.def order (also the saved unlock flag order)
+    s.items.clear();
+    for (WeaponType t : weapon_types())
+        s.items.push_back({t, weapon_info(t).starter});
     s.dragging = false;
     s.drag_index = -1;
     s.mouse_prev_down = false;
     s.suppress_drag_until_release = false;
     s.money_warn_timer = 0;
-    preload_images(s);
+}
+
+void init_shop(ShopState &s)
+{
+    init_shop_items(s);
+    load_weapon_images();
+}
+
+bool shop_unlock(ShopState &s, int index, int &money)
+{
+    if (index < 0 || index >= (int)s.items.size() || s.items[index].unlocked)
+        return false;
+    int price = weapon_info(s.items[index].type).price;
+    if (money < price)
+        return false;
+    money -= price;
+    s.items[index].unlocked = true;
+    return true;
+}
+
+bool shop_equip(const ShopState &s, int index, int slot,
+                std::vector<std::unique_ptr<WeaponBase>> &weapons,
+                int &current_weapon,
+                bool load_assets)
+{
+    if (index < 0 || index >= (int)s.items.size() || (slot != 0 && slot != 1))
+        return false;
+    const auto &it = s.items[index];
+    if (!it.unlocked)
+        return false;
+
+    if (weapons.size() < 2)
+        weapons.resize(2);
+    int other = slot == 0 ? 1 : 0;
+    if (weapon_type_of(weapons[other].get()) == it.type)
+        return false; // same weapon already in the other slot
+
+    std::unique_ptr<WeaponBase> nw = create_weapon(it.type);
+    if (!nw)
+        return false;
+
+    if (load_assets)
+        nw->load_assets();
+    weapons[slot] = std::move(nw);
+    current_weapon = slot;
+    return true;
 }
 
 bool update_shop(ShopState &s,
+                 const InputState &in,
                  std::vector<std::unique_ptr<WeaponBase>> &weapons,
                  int &current_weapon,
                  int &money)
 {
-    bool now_down = mouse_down(LEFT_BUTTON);
+    bool now_down = in.fire_down;
     bool released_now = (!now_down && s.mouse_prev_down);
     bool clicked_now = (now_down && !s.mouse_prev_down);
     if (s.money_warn_timer > 0) s.money_warn_timer--;
 
-    // Card layout (grid)
-    const double start_x = 240;
-    const double start_y = 260;
-    const double gap_x = 140;
-    const double gap_y = 24;
-    const double card_w = 170;
-    const double card_h = 140;
-    const int cols = 3;
-
     // Determine hovered card
     int hovered_idx = -1;
-    double mx = mouse_x(), my = mouse_y();
+    double mx = in.mouse_x, my = in.mouse_y;
     for (int i = 0; i < (int)s.items.size(); ++i)
     {
-        int col = i % cols;
-        int row = i / cols;
-        double cx = start_x + col * (card_w + gap_x);
-        double cy = start_y + row * (card_h + gap_y);
+        double cx, cy;
+        card_pos(i, cx, cy);
         if (mx >= cx && mx <= cx + card_w && my >= cy && my <= cy + card_h)
         {
             hovered_idx = i;
@@ -60,16 +109,10 @@ bool update_shop(ShopState &s,
     // Unlock on click
     if (clicked_now && hovered_idx >= 0 && !s.items[hovered_idx].unlocked)
     {
-        if (money >= s.items[hovered_idx].price)
-        {
-            money -= s.items[hovered_idx].price;
-            s.items[hovered_idx].unlocked = true;
+        if (shop_unlock(s, hovered_idx, money))
             s.suppress_drag_until_release = true;
-        }
         else
-        {
             s.money_warn_timer = 30; // trigger warning animation
-        }
     }
 
     // Start drag for unlocked items
@@ -90,11 +133,6 @@ bool update_shop(ShopState &s,
             s.suppress_drag_until_release = false;
 
             // Slot layout (same as draw)
-            double slot_y = 620;
-            double slot_w = 144;
-            double slot_h = 120;
-            double slot_x1 = 380;
-            double slot_x2 = 760;
             int target_slot = -1;
             if (s.drag_x >= slot_x1 && s.drag_x <= slot_x1 + slot_w && s.drag_y >= slot_y && s.drag_y <= slot_y + slot_h)
                 target_slot = 0;
@@ -102,44 +140,7 @@ bool update_shop(ShopState &s,
                 target_slot = 1;
 
             if (target_slot != -1 && s.drag_index >= 0)
-            {
-                auto &it = s.items[s.drag_index];
-                if (it.unlocked)
-                {
-                    std::unique_ptr<WeaponBase> nw;
-                    if (it.type == 0)
-                        nw = std::make_unique<Pistol>();
-                    else if (it.type == 1)
-                        nw = std::make_unique<AK>();
-                    else if (it.type == 2)
-                        nw = std::make_unique<Shotgun>();
-                    else if (it.type == 3)
-                        nw = std::make_unique<AWP>();
-                    
-
-                    if (nw)
-                    {
-                        nw->load_assets();
-                        if (weapons.size() < 2)
-                            weapons.resize(2);
-                        int other = target_slot == 0 ? 1 : 0;
-                        bool same_type = false;
-                        if (weapons.size() > other && weapons[other])
-                        {
-                            if ((it.type == 0 && dynamic_cast<Pistol *>(weapons[other].get())) ||
-                                (it.type == 1 && dynamic_cast<AK *>(weapons[other].get())) ||
-                                (it.type == 2 && dynamic_cast<Shotgun *>(weapons[other].get())) ||
-                                (it.type == 3 && dynamic_cast<AWP *>(weapons[other].get())))
-                                same_type = true;
-                        }
-                        if (!same_type)
-                        {
-                            weapons[target_slot] = std::move(nw);
-                            current_weapon = target_slot;
-                        }
-                    }
-                }
-            }
+                shop_equip(s, s.drag_index, target_slot, weapons, current_weapon);
 
             s.dragging = false;
             s.drag_index = -1;
@@ -149,7 +150,7 @@ bool update_shop(ShopState &s,
     if (!now_down)
         s.suppress_drag_until_release = false;
 
-    if (key_typed(ESCAPE_KEY) || key_typed(SPACE_KEY) || key_typed(RETURN_KEY))
+    if (in.close_typed)
     {
         s.mouse_prev_down = now_down;
         return true;
@@ -160,7 +161,7 @@ bool update_shop(ShopState &s,
 }
 
 void draw_shop(const ShopState &s,
-               const std::vector<std::unique_ptr<WeaponBase>> &weapons,
+               const WeaponType (&slots)[2],
                int money,
                int screen_w)
 {
@@ -178,15 +179,13 @@ void draw_shop(const ShopState &s,
         draw_text("Money: $" + std::to_string(money), money_col, "arial", 26, money_x, money_y);
     }
 
-    double start_x = 240, start_y = 260, gap_x = 140, gap_y = 24, card_w = 170, card_h = 140;
-    int cols = 3;
     for (int i = 0; i < (int)s.items.size(); ++i)
     {
-        int col = i % cols, row = i / cols;
-        double cx = start_x + col * (card_w + gap_x);
-        double cy = start_y + row * (card_h + gap_y);
+        double cx, cy;
+        card_pos(i, cx, cy);
         draw_rectangle(COLOR_BLACK, cx, cy, card_w, card_h);
-        bitmap img = bitmap_named(s.items[i].image_key);
+        const WeaponInfo &info = weapon_info(s.items[i].type);
+        bitmap img = info.icon;
         if (img)
         {
             double iw = bitmap_width(img) * 2.0;
@@ -196,11 +195,10 @@ void draw_shop(const ShopState &s,
             draw_bitmap(img, ix, iy, option_scale_bmp(2.0, 2.0, option_flip_x()));
         }
         color tc = s.items[i].unlocked ? COLOR_GREEN : COLOR_RED;
-        draw_text(s.items[i].name + (s.items[i].unlocked?" (Unlocked)":""), tc, "arial", 18, cx + 6, cy + card_h - 40);
-        draw_text("$" + std::to_string(s.items[i].price), COLOR_BLACK, "arial", 18, cx + 6, cy + card_h - 24);
+        draw_text(std::string(info.name) + (s.items[i].unlocked?" (Unlocked)":""), tc, "arial", 18, cx + 6, cy + card_h - 40);
+        draw_text("$" + std::to_string(info.price), COLOR_BLACK, "arial", 18, cx + 6, cy + card_h - 24);
     }
 
-    double slot_y = 620; double slot_w = 144; double slot_h = 120; double slot_x1 = 380; double slot_x2 = 760;
     draw_rectangle(COLOR_BLACK, slot_x1, slot_y, slot_w, slot_h);
     draw_rectangle(COLOR_BLACK, slot_x2, slot_y, slot_w, slot_h);
 
@@ -215,30 +213,20 @@ void draw_shop(const ShopState &s,
         draw_bitmap(img, ix, iy, option_scale_bmp(scale, scale, option_flip_x()));
     };
 
-    if (weapons.size() > 0 && weapons[0])
+    if (slots[0] != WeaponType::None)
     {
-        bitmap img = nullptr;
-        if (dynamic_cast<Pistol*>(weapons[0].get())) img = bitmap_named("weapon_img_0");
-        else if (dynamic_cast<AK*>(weapons[0].get())) img = bitmap_named("weapon_ak_img");
-        else if (dynamic_cast<Shotgun*>(weapons[0].get())) img = bitmap_named("shotgun_img");
-        else if (dynamic_cast<AWP*>(weapons[0].get())) img = bitmap_named("awp_img");
-        draw_slot_img(img, slot_x1, slot_y, slot_w, slot_h);
+        draw_slot_img(weapon_info(slots[0]).icon, slot_x1, slot_y, slot_w, slot_h);
         draw_text("Slot 1", COLOR_BLACK, "arial", 18, slot_x1 + 8, slot_y + 8);
     }
-    if (weapons.size() > 1 && weapons[1])
+    if (slots[1] != WeaponType::None)
     {
-        bitmap img = nullptr;
-        if (dynamic_cast<Pistol*>(weapons[1].get())) img = bitmap_named("weapon_img_0");
-        else if (dynamic_cast<AK*>(weapons[1].get())) img = bitmap_named("weapon_ak_img");
-        else if (dynamic_cast<Shotgun*>(weapons[1].get())) img = bitmap_named("shotgun_img");
-        else if (dynamic_cast<AWP*>(weapons[1].get())) img = bitmap_named("awp_img");
-        draw_slot_img(img, slot_x2, slot_y, slot_w, slot_h);
+        draw_slot_img(weapon_info(slots[1]).icon, slot_x2, slot_y, slot_w, slot_h);
         draw_text("Slot 2", COLOR_BLACK, "arial", 18, slot_x2 + 8, slot_y + 8);
     }
 
     if (s.dragging && s.drag_index >= 0)
     {
-        bitmap img = bitmap_named(s.items[s.drag_index].image_key);
+        bitmap img = weapon_info(s.items[s.drag_index].type).icon;
         if (img)
             draw_bitmap(img, s.drag_x - bitmap_width(img), s.drag_y - bitmap_height(img), option_scale_bmp(2.0, 2.0, option_flip_x()));
     }
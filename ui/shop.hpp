@@ -6,16 +6,13 @@
 #include <string>
 #include "splashkit.h"
 #include "../weapon/weapon_base.hpp"
+#include "../weapon/weapon_registry.hpp"
+#include "../game/input.hpp"
 
+// Name, icon and price come from the weapon registry
 struct ShopItem
 {
-    std::string name;
-    std::string image_key;
-    std::string image_path;
-    int price;
-    std::string dmg;
-    std::string rof;
-    int type;      // 0=Pistol,1=AK,2=Shotgun,3=AWP
+    WeaponType type;
     bool unlocked; // true after purchased
 };
 
@@ -34,18 +31,32 @@ struct ShopState
 };
 
 void init_shop(ShopState &s);
+void init_shop_items(ShopState &s); // Item list only, no image preload (headless worlds, simulation thread)
 inline bool shop_is_open(const ShopState &s) { return s.open; }
 inline void open_shop(ShopState &s) { s.open = true; }
 inline void close_shop(ShopState &s) { s.open = false; s.dragging = false; s.drag_index = -1; }
 
-// Returns true when user confirms to start next wave (ESC/Enter/Space)
+// One step of the open shop under the mouse and keys of `in`; returns true
+// when the user confirms to start next wave (ESC/Enter/Space)
 bool update_shop(ShopState &s,
+                 const InputState &in,
                  std::vector<std::unique_ptr<WeaponBase>> &weapons,
                  int &current_weapon,
                  int &money);
 
+// Buy item `index`; false when already owned or not affordable
+bool shop_unlock(ShopState &s, int index, int &money);
+
+// Put unlocked item `index` into weapon slot 0/1 and select it; refuses a
+// duplicate of the weapon in the other slot
+bool shop_equip(const ShopState &s, int index, int slot,
+                std::vector<std::unique_ptr<WeaponBase>> &weapons,
+                int &current_weapon,
+                bool load_assets = true);
+
+// Draw the shop; the equip slots show `slots` (WeaponType::None: empty)
 void draw_shop(const ShopState &s,
-               const std::vector<std::unique_ptr<WeaponBase>> &weapons,
+               const WeaponType (&slots)[2],
                int money,
                int screen_w);
 
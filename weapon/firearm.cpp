@@ -0,0 +1,456 @@
+// Firearm: the one weapon engine, driven by a WeaponInfo row from weapons.def.
+#include "weapon_base.hpp"
+#include "weapon_registry.hpp"
+#include "../game/game_world.hpp"
+#include "../game/audio.hpp"
+#include "../enemy/enemy_base.hpp"
+#include "../render/sprite_cache.hpp"
+#include "../render/world_layer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static const double kPi = 3.141592654;
+
+// base + rand() % extra, tolerating extra == 0
+static int roll(int base, int extra)
+{
+    return extra > 0 ? base + rand() % extra : base;
+}
+
+// Scatter sparks opposite to the bullet heading
+static void create_sparks(WeaponFx &fx, const SparkStyle &style, double x, double y, double bullet_angle_rad)
+{
+    int count = roll(style.count, style.count_rand);
+    for (int i = 0; i < count; ++i)
+    {
+        Spark s;
+        s.x = x;
+        s.y = y;
+        double spread = roll(-style.spread_deg, 2 * style.spread_deg + 1) * (kPi / 180.0);
+        double dir = bullet_angle_rad + kPi + spread;
+        double speed = roll(style.speed, style.speed_rand);
+        s.dx = cos(dir) * speed;
+        s.dy = sin(dir) * speed;
+        s.length = roll(style.length, style.length_rand);
+        s.life = 1.0;
+        fx.sparks.push_back(s);
+    }
+}
+
+// Which of the four muzzle/ejection cases applies: facing right aiming left,
+// facing right aiming right, facing left aiming right, facing left aiming left
+static int aim_case(const player_data &player, double aim_x)
+{
+    if (player.facing == FACING_RIGHT)
+        return aim_x < player.player_x ? 0 : 1;
+    return aim_x > player.player_x ? 2 : 3;
+}
+
+void Firearm::load_assets()
+{
+    const WeaponInfo &d = *def_;
+    image_ = d.icon;
+    fire_image_ = d.fire_image;
+    shown_image_ = image_;
+    bullet_img_ = d.bullet_image;
+    fx_.muzzle_img = d.muzzle_image;
+    fx_.shell_img = d.shell_image;
+}
+
+WeaponType Firearm::type_id() const
+{
+    return def_->type;
+}
+
+void Firearm::update(GameWorld &world, const InputState &in)
+{
+    const WeaponInfo &d = *def_;
+    const player_data &player = world.player;
+    double center_x = player.player_x + player.player_width / 2;
+    double center_y = player.player_y + player.player_hight / 2;
+
+    if (fire_cooldown_ > 0)
+        fire_cooldown_--;
+    if (fx_.muzzle_timer > 0)
+        fx_.muzzle_timer--; // Before firing: a flash shows for muzzle_time ticks
+
+    // Angle from player center to the crosshair
+    double angle_rad = atan2(in.aim_y - center_y, in.aim_x - center_x);
+
+    bool trigger = d.full_auto ? in.fire_down : in.fire_clicked;
+
+    // Barrel spin: builds while the trigger is held, decays when released
+    if (trigger)
+    {
+        if (spin_ == 0 && !d.spin_sound_key.empty())
+            play_sfx(world, d.spin_sound_key, d.spin_sound_path, d.spin_volume);
+        if (spin_ < d.spin_up)
+            spin_++;
+    }
+    else if (spin_ > 0)
+    {
+        spin_--;
+    }
+    bool spun_up = spin_ >= d.spin_up;
+
+    if (trigger && spun_up && fire_cooldown_ == 0 && !(d.wait_recoil && is_recoiling_))
+        fire(world, in, angle_rad);
+    set_voice(world, trigger && spun_up);
+
+    // Recoil recovery
+    if (is_recoiling_)
+    {
+        recoil_timer_--;
+        if (recoil_timer_ <= 0)
+        {
+            is_recoiling_ = false;
+            recoil_timer_ = 0;
+        }
+    }
+
+    // Fire sprite recovery
+    if (fire_frame_timer_ > 0)
+    {
+        fire_frame_timer_--;
+        shown_image_ = fire_image_;
+    }
+    else
+    {
+        shown_image_ = image_;
+    }
+
+    update_projectiles(world);
+}
+
+void Firearm::fire(GameWorld &world, const InputState &in, double angle_rad)
+{
+    const WeaponInfo &d = *def_;
+    const player_data &player = world.player;
+    double grip_x = player.player_x + d.grip_x;
+    double grip_y = player.player_y + d.grip_y;
+
+    fire_cooldown_ = d.fire_interval;
+    is_recoiling_ = true;
+    recoil_timer_ = d.recoil_duration;
+    fire_frame_timer_ = d.fire_frame_time;
+
+    // One bullet per pellet offset
+    Bullet b;
+    b.x = player.player_x + player.player_width / 2;
+    b.y = player.player_y + player.player_hight / 2;
+    b.speed = d.bullet_speed;
+    b.active = true;
+    b.weapon_id = (int)d.type;
+    b.damage = d.damage;
+    b.image = bullet_img_;
+    b.piercing = d.piercing;
+    b.pierce_left = d.pierce_limit;
+    b.falloff = d.pierce_falloff;
+    for (int i = 0; i < d.pellet_count; ++i)
+    {
+        double spread = d.spread_deg > 0 ? (world.rng.unit() * 2 - 1) * d.spread_deg : 0;
+        double a = angle_rad + (d.pellets[i] + spread) * (kPi / 180.0);
+        if (d.hitscan > 0)
+        {
+            fire_ray(world, b.x, b.y, a, b.damage);
+            continue;
+        }
+        b.dx = cos(a) * b.speed;
+        b.dy = sin(a) * b.speed;
+        emit_bullet(bullets_, b, next_slot_);
+    }
+
+    fx_.muzzle_x = grip_x + cos(angle_rad) * 45;
+    fx_.muzzle_y = grip_y + sin(angle_rad) * 45;
+    fx_.muzzle_timer = d.muzzle_time;
+
+    // Shell ejection (cosmetic, skipped for headless worlds)
+    if (!world.headless)
+    {
+        Shell s;
+        s.x = grip_x;
+        s.y = grip_y + 15;
+        int side = aim_case(player, in.aim_x);
+        bool eject_back = d.shell_follows_aim ? (side == 0 || side == 3) : player.facing != FACING_RIGHT;
+        double ejection_angle = (eject_back ? -0.5 : 3.14 - 0.5) + ((rand() % 20) / 100.0);
+        double speed = 5 + rand() % 3;
+        s.dx = cos(ejection_angle) * speed;
+        s.dy = sin(ejection_angle) * speed;
+        s.rotation = rand() % 360;
+        s.spin = (rand() % 20 - 10) * 0.2;
+        s.life = 1.0;
+        s.image = fx_.shell_img;
+        fx_.shells.push_back(s);
+    }
+
+    if (!d.sound_key.empty())
+        play_sfx(world, d.sound_key, d.sound_path, d.volume);
+}
+
+// Hitscan: the ray runs to the arena edge or the first obstacle through the
+// enemy index and hits enemies nearest first until `hitscan` of them took the
+// hit. Enemies that refuse the hit (e.g. the boss between phases) let the ray
+// pass.
+void Firearm::fire_ray(GameWorld &world, double x, double y, double angle_rad, int damage)
+{
+    const WeaponInfo &d = *def_;
+    double ux = cos(angle_rad), uy = sin(angle_rad);
+    double tx = ux > 0 ? (world.arena_w - x) / ux : ux < 0 ? -x / ux : 1e9;
+    double ty = uy > 0 ? (world.arena_h - y) / uy : uy < 0 ? -y / uy : 1e9;
+    double range = std::max(0.0, std::min(tx, ty));
+    bool walled = world.obstacles->raycast(x, y, ux, uy, range, range);
+
+    world.enemy_index.refresh(world.enemies, world.arena_w, world.arena_h);
+    world.enemy_index.raycast(x, y, ux, uy, range, hits_);
+    double end = range;
+    int landed = 0;
+    for (const RayHit &h : hits_)
+    {
+        EnemyBase &e = *world.enemies[h.enemy];
+        if (!hit_enemy(world, e, damage))
+            continue; // killed by an earlier pellet, or immune right now
+        damage = (int)std::lround(damage * d.pierce_falloff);
+        if (!world.headless)
+            create_sparks(fx_, d.sparks, x + ux * h.t, y + uy * h.t, angle_rad);
+        if (++landed == d.hitscan)
+        {
+            end = h.t;
+            walled = false;
+            break;
+        }
+    }
+    if (walled && !world.headless)
+        create_sparks(fx_, d.sparks, x + ux * end, y + uy * end, angle_rad);
+
+    fx_.beam_x0 = x;
+    fx_.beam_y0 = y;
+    fx_.beam_x1 = x + ux * end;
+    fx_.beam_y1 = y + uy * end;
+    fx_.beam_timer = d.beam_time;
+}
+
+// Looped fire sound: started once when sustained fire begins instead of one
+// sound per bullet
+void Firearm::set_voice(GameWorld &world, bool on)
+{
+    const WeaponInfo &d = *def_;
+    if (on == voice_on_ || d.loop_sound_key.empty() || world.headless)
+        return;
+    if (on)
+        start_sfx_loop(world, d.loop_sound_key, d.loop_sound_path, d.loop_volume);
+    else
+        stop_sfx(world, d.loop_sound_key);
+    voice_on_ = on;
+}
+
+void Firearm::silence(GameWorld &world)
+{
+    if (voice_on_)
+        stop_sfx(world, def_->loop_sound_key);
+    voice_on_ = false;
+}
+
+// Homing: every live bullet asks the enemy index for the nearest enemy in
+// its search cone (one batch per tick, after the shots of this tick) and
+// turns toward it by at most homing_turn_deg, keeping its speed
+void Firearm::steer_homing(GameWorld &world)
+{
+    const WeaponInfo &d = *def_;
+    const double min_cos = d.homing_cone_deg >= 180 ? -1 : cos(d.homing_cone_deg * (kPi / 180.0));
+    seek_.clear();
+    for (const auto &b : bullets_)
+    {
+        if (!b.active)
+            continue;
+        double len = sqrt(b.dx * b.dx + b.dy * b.dy);
+        if (len == 0)
+            continue;
+        seek_.push_back({b.x, b.y, d.homing_radius, b.dx / len, b.dy / len, min_cos});
+    }
+    if (seek_.empty())
+        return;
+
+    world.enemy_index.refresh(world.enemies, world.arena_w, world.arena_h);
+    world.enemy_index.nearest(seek_, targets_);
+    const double max_turn = d.homing_turn_deg * (kPi / 180.0);
+    size_t k = 0;
+    for (auto &b : bullets_)
+    {
+        if (!b.active || (b.dx == 0 && b.dy == 0))
+            continue;
+        int i = targets_[k++];
+        if (i < 0 || !world.enemies[i]->alive)
+            continue;
+        const HitRect aim = world.enemies[i]->hurtbox();
+        double heading = atan2(b.dy, b.dx);
+        double turn = remainder(atan2(aim.y + aim.h / 2 - b.y, aim.x + aim.w / 2 - b.x) - heading, 2 * kPi);
+        heading += std::clamp(turn, -max_turn, max_turn);
+        double len = sqrt(b.dx * b.dx + b.dy * b.dy);
+        b.dx = cos(heading) * len;
+        b.dy = sin(heading) * len;
+    }
+}
+
+void Firearm::update_projectiles(GameWorld &world)
+{
+    const ViewRect active = active_region(world);
+    if (def_->homing_turn_deg > 0)
+        steer_homing(world);
+    for (auto &b : bullets_)
+    {
+        bool prev = b.was_active;
+        b.was_active = b.active;
+
+        // Sparks on the frame a bullet is spent
+        if (prev && !b.active)
+        {
+            if (!world.headless)
+                create_sparks(fx_, def_->sparks, b.x, b.y, atan2(b.dy, b.dx));
+            continue;
+        }
+
+        if (!b.active)
+            continue;
+
+        b.x += b.dx;
+        b.y += b.dy;
+
+        // Deactivate when out of the arena or the active region
+        if (b.x < 0 || b.x > world.arena_w || b.y < 0 || b.y > world.arena_h || !active.sees(b.x, b.y, 0))
+            b.active = false;
+    }
+
+    if (fx_.beam_timer > 0)
+        fx_.beam_timer--;
+
+    // Sparks and shells, compacted in place so their capacity is reused
+    for (auto &s : fx_.sparks)
+    {
+        s.x += s.dx;
+        s.y += s.dy;
+        s.life -= 0.05;
+    }
+    fx_.sparks.erase(std::remove_if(fx_.sparks.begin(), fx_.sparks.end(),
+                                    [](const Spark &s) { return s.life <= 0; }),
+                     fx_.sparks.end());
+
+    for (auto &s : fx_.shells)
+    {
+        s.x += s.dx;
+        s.y += s.dy;
+        s.dy += 0.3; // Gravity
+        s.rotation += s.spin;
+        s.life -= 0.01;
+    }
+    double floor_y = world.arena_h + 50;
+    fx_.shells.erase(std::remove_if(fx_.shells.begin(), fx_.shells.end(),
+                                    [floor_y](const Shell &s) { return s.life <= 0 || s.y >= floor_y; }),
+                     fx_.shells.end());
+}
+
+void Firearm::capture(const player_data &player, double aim_x, double aim_y, const ViewRect &view,
+                      WorldLayer &out) const
+{
+    const WeaponInfo &d = *def_;
+    double weapon_x = player.player_x + d.draw_x;
+    double weapon_y = player.player_y + d.draw_y;
+    double angle_rad = atan2(aim_y - weapon_y, aim_x - weapon_x);
+    double angle_deg = angle_rad * 180.0 / kPi;
+
+    // Recoil kick along the barrel
+    double recoil_offset = 0.0;
+    if (is_recoiling_)
+    {
+        double t = static_cast<double>(recoil_timer_) / d.recoil_duration;
+        recoil_offset = d.recoil_strength * t;
+    }
+
+    // Flip so the sprite stays upright on either side of the player (the
+    // flipped copies are cached; only the aim rotation is per draw)
+    int side = aim_case(player, aim_x);
+    bool upright_flip = side == 0 || side == 2;
+    if (shown_image_)
+    {
+        SpriteView gun;
+        gun.image = shown_image_;
+        gun.x = weapon_x + cos(angle_rad + kPi) * recoil_offset;
+        gun.y = weapon_y + sin(angle_rad + kPi) * recoil_offset;
+        gun.flip_x = player.facing == FACING_RIGHT;
+        gun.flip_y = upright_flip;
+        gun.angle = upright_flip ? angle_deg + 180 : angle_deg;
+        out.sprites.push_back(gun);
+    }
+
+    // Sprites rotated to one of the cached steps
+    auto rotated = [&out](bitmap image, double x, double y, int step, double scale = 1) {
+        SpriteView s;
+        s.image = image;
+        s.x = x;
+        s.y = y;
+        s.step = step;
+        s.scale = scale;
+        out.sprites.push_back(s);
+    };
+
+    // Muzzle flash
+    if (fx_.muzzle_timer > 0 && fx_.muzzle_img)
+        rotated(fx_.muzzle_img, fx_.muzzle_x + d.muzzle_dx[side], fx_.muzzle_y + d.muzzle_dy[side],
+                rotation_step_deg(angle_deg));
+
+    // Bullets, sparks and shells outside the view are skipped
+    const double margin = 32;
+    for (const auto &b : bullets_)
+        if (b.active && b.image && view.sees(b.x, b.y, margin))
+            rotated(b.image, b.x, b.y, rotation_step(b.dx, b.dy));
+
+    // Hitscan beam: the bullet sprite repeated along the ray
+    if (fx_.beam_timer > 0 && bullet_img_)
+    {
+        double bx = fx_.beam_x1 - fx_.beam_x0, by = fx_.beam_y1 - fx_.beam_y0;
+        double len = sqrt(bx * bx + by * by);
+        double step = std::max(8, bitmap_width(bullet_img_));
+        int beam_step = rotation_step(bx, by);
+        for (double s = 0; s < len; s += step)
+            rotated(bullet_img_, fx_.beam_x0 + bx * s / len, fx_.beam_y0 + by * s / len, beam_step);
+    }
+
+    // Sparks
+    const SparkStyle &st = d.sparks;
+    for (const auto &s : fx_.sparks)
+    {
+        if (!view.sees(s.x, s.y, s.length))
+            continue;
+        color c = rgba_color(st.r, roll(st.g, st.g_rand), st.b, (int)(s.life * 255));
+        double tail_x = s.x - cos(atan2(s.dy, s.dx)) * s.length;
+        double tail_y = s.y - sin(atan2(s.dy, s.dx)) * s.length;
+        out.lines.push_back({c, s.x, s.y, tail_x, tail_y});
+    }
+
+    // Shells fade out with scale
+    for (const auto &s : fx_.shells)
+        if (s.image && view.sees(s.x, s.y, margin))
+            rotated(s.image, s.x, s.y, rotation_step_deg(s.rotation), 0.5 + 0.5 * s.life);
+}
+
+void Firearm::save_state(ByteWriter &w) const
+{
+    w.field(fire_cooldown_); w.field(fire_frame_timer_); w.field(is_recoiling_); w.field(recoil_timer_);
+    w.field(spin_); w.field(next_slot_);
+    w.records(bullets_);
+}
+
+void Firearm::load_state(ByteReader &r)
+{
+    r.field(fire_cooldown_); r.field(fire_frame_timer_); r.field(is_recoiling_); r.field(recoil_timer_);
+    r.field(spin_); r.field(next_slot_);
+    voice_on_ = false; // read_world silenced the live voice before restoring
+    r.records(bullets_);
+    for (auto &b : bullets_)
+        b.image = bullet_img_; // sprite handles are not part of the snapshot
+    shown_image_ = fire_frame_timer_ > 0 ? fire_image_ : image_;
+    fx_.sparks.clear();
+    fx_.shells.clear();
+    fx_.muzzle_timer = 0;
+    fx_.beam_timer = 0;
+}
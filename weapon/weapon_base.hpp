@@ -1,9 +1,16 @@
 #pragma once
 #include "splashkit.h"
 #include "../player/player.hpp"
+#include "../game/input.hpp"
+#include "../game/snapshot.hpp"
+#include "../game/enemy_index.hpp"
+#include "../game/camera.hpp"
 #include <vector>
 #include <cmath>
 
+struct GameWorld;  // game/game_world.hpp
+struct WorldLayer; // render/world_layer.hpp
+
 // Bullet structure representing each fired projectile
 struct Bullet
 {
@@ -18,8 +25,41 @@ struct Bullet
     int damage = 0;          // Damage value of the bullet
     bitmap image;            // Bullet sprite
     bool piercing = false;   // If true, bullet does not deactivate on hit
+    int pierce_left = 0;     // Piercing: enemies it may still hit (0 = no cap)
+    double falloff = 1.0;    // Piercing: damage kept after each hit
+
+    // Snapshot fields (the sprite is rebound by the owning weapon)
+    template <class Stream, class Self>
+    static void transfer(Stream &s, Self &b)
+    {
+        s.field(b.x); s.field(b.y); s.field(b.dx); s.field(b.dy); s.field(b.speed);
+        s.field(b.active); s.field(b.was_active); s.field(b.weapon_id); s.field(b.damage); s.field(b.piercing);
+        s.field(b.pierce_left); s.field(b.falloff);
+    }
 };
 
+// Store a freshly fired bullet, reusing a spent slot (inactive and past its
+// spark frame) so the list stops growing once it covers the fire rate.
+// The search resumes at `cursor`, just past the last slot used: bullets of
+// one weapon expire roughly in firing order, so the next free slot is
+// usually the first one looked at, even for several bullets per tick.
+inline void emit_bullet(std::vector<Bullet> &arr, const Bullet &b, uint32_t &cursor)
+{
+    const uint32_t n = (uint32_t)arr.size();
+    for (uint32_t k = 0; k < n; ++k)
+    {
+        uint32_t i = (cursor + k) % n;
+        if (!arr[i].active && !arr[i].was_active)
+        {
+            arr[i] = b;
+            cursor = i + 1;
+            return;
+        }
+    }
+    arr.push_back(b);
+    cursor = 0; // the wrap-around scan restarts at the oldest slots
+}
+
 // Spark structure for bullet hit visual effect
 struct Spark
 {
@@ -29,94 +69,109 @@ struct Spark
     double length; // Spark lifetime
 };
 
-extern std::vector<Spark> sparks;
-
-// Abstract base class for all weapons
-class WeaponBase
+// Shell casing ejected on each shot
+struct Shell
 {
-public:
-    virtual ~WeaponBase() = default;                    // Virtual destructor
-    virtual void load_assets() = 0;                     // Load textures and resources
-    virtual void update(const player_data &player) = 0; // Update weapon logic
-    virtual void draw(const player_data &player) = 0;   // Draw weapon and bullets
-    virtual std::vector<Bullet> &bullets() = 0;         // Return reference to bullet list
+    double x, y;     // Position
+    double dx, dy;   // Velocity
+    double rotation; // Current rotation angle
+    double spin;     // Spin speed
+    double life;     // Remaining life (1~0)
+    bitmap image;    // Shell sprite
 };
 
-// Pistol class derived from WeaponBase
-class Pistol : public WeaponBase
+// Visual effect state owned by each weapon instance
+struct WeaponFx
 {
-public:
-    void load_assets() override;                                 // Load pistol assets
-    void update(const player_data &player) override;             // Update pistol logic
-    void draw(const player_data &player) override;               // Draw pistol and bullets
-    std::vector<Bullet> &bullets() override { return bullets_; } // Access bullet list
-
-private:
-    bitmap image_{nullptr};       // Pistol sprite
-    std::vector<Bullet> bullets_; // Bullets fired by pistol
-
-    int fire_cooldown = 0;        // Fire cooldown timer
-    const int fire_interval = 20; // Frames between shots
-
-    bool is_recoiling = false;          // Whether pistol is recoiling
-    int recoil_timer = 0;               // Recoil timer
-    const int recoil_duration = 10;     // Total recoil duration
-    const double recoil_strength = 5.0; // Strength of recoil effect
+    std::vector<Spark> sparks;         // Bullet hit sparks
+    std::vector<Shell> shells;         // Ejected shells
+    bitmap shell_img = nullptr;        // Shell sprite
+    bitmap muzzle_img = nullptr;       // Muzzle flash sprite
+    int muzzle_timer = 0;              // Muzzle flash display timer
+    double muzzle_x = 0, muzzle_y = 0; // Muzzle flash position
+    int beam_timer = 0;                // Hitscan beam display timer
+    double beam_x0 = 0, beam_y0 = 0;   // Beam start (muzzle)
+    double beam_x1 = 0, beam_y1 = 0;   // Beam end (last enemy hit, obstacle or arena edge)
 };
 
-// AK class derived from WeaponBase
-class AK : public WeaponBase
+// Stable weapon type ids, stored in saves and snapshots (never renumber).
+// The ids are defined in weapon/weapons.def; the names below are the ones
+// the code refers to directly.
+enum class WeaponType : int8_t
 {
-public:
-    void load_assets() override;                                 // Load AK assets
-    void update(const player_data &player) override;             // Update AK logic
-    void draw(const player_data &player) override;               // Draw AK and bullets
-    std::vector<Bullet> &bullets() override { return bullets_; } // Access bullet list
-
-private:
-    bitmap image_{nullptr};       // AK sprite
-    std::vector<Bullet> bullets_; // Bullets fired by AK
-
-    int fire_cooldown_ = 0;        // Fire cooldown timer
-    const int fire_interval_ = 20; // Frames between shots
-
-    bool is_recoiling_ = false;          // Whether AK is recoiling
-    int recoil_timer_ = 0;               // Recoil timer
-    const int recoil_duration_ = 20;     // Total recoil duration
-    const double recoil_strength_ = 8.0; // Strength of recoil effect
+    None = -1,
+    Pistol = 0,
+    AK = 1,
+    Shotgun = 2,
+    AWP = 3,
+    Gatling = 4,
+    Kleber = 5,
+    Seeker = 6,
 };
 
-// Shotgun weapon
-class Shotgun : public WeaponBase
+// Abstract base class for all weapons
+class WeaponBase
 {
 public:
-    void load_assets() override;
-    void update(const player_data &player) override;
-    void draw(const player_data &player) override;
-    std::vector<Bullet> &bullets() override { return bullets_; }
+    virtual ~WeaponBase() = default;                    // Virtual destructor
+    virtual void load_assets() = 0;                     // Pick up sprites preloaded by load_weapon_images
+    virtual void update(GameWorld &world, const InputState &in) = 0; // Update weapon logic
+    // Add the weapon held by `player` and aimed at (aim_x, aim_y), its
+    // bullets and effects to the render snapshot's world layer (culled to view)
+    virtual void capture(const player_data &player, double aim_x, double aim_y, const ViewRect &view,
+                         WorldLayer &out) const = 0;
+    virtual std::vector<Bullet> &bullets() = 0;         // Return reference to bullet list
+    virtual WeaponType type_id() const = 0;             // Registry id of this weapon
+    virtual void silence(GameWorld &world) { (void)world; } // Stop looping sounds (holstered or paused)
 
-private:
-    bitmap image_{nullptr};
-    std::vector<Bullet> bullets_;
-    int fire_cooldown_ = 0;
-    const int fire_interval_ = 56; // reduced rate (half of previous)
+    // Snapshot support: cooldowns, recoil and live bullets (VFX are dropped)
+    virtual void save_state(ByteWriter &w) const = 0;
+    virtual void load_state(ByteReader &r) = 0;
 };
 
-// AWP sniper (piercing, high damage, slow)
-class AWP : public WeaponBase
+struct WeaponInfo; // weapon_registry.hpp
+
+// The weapon engine: every weapon is a Firearm driven by its definition row
+// (trigger, cooldown, pellets, recoil, muzzle flash, shells, sparks).
+// Firing reuses bullet, spark and shell slots, so shots do not allocate once
+// the vectors have grown to the weapon's fire rate.
+class Firearm : public WeaponBase
 {
 public:
+    explicit Firearm(const WeaponInfo &def) : def_(&def) {}
     void load_assets() override;
-    void update(const player_data &player) override;
-    void draw(const player_data &player) override;
+    void update(GameWorld &world, const InputState &in) override;
+    void capture(const player_data &player, double aim_x, double aim_y, const ViewRect &view,
+                 WorldLayer &out) const override;
     std::vector<Bullet> &bullets() override { return bullets_; }
+    WeaponType type_id() const override;
+    void silence(GameWorld &world) override;
+    void save_state(ByteWriter &w) const override;
+    void load_state(ByteReader &r) override;
 
 private:
-    bitmap image_{nullptr};
-    std::vector<Bullet> bullets_;
-    int fire_cooldown_ = 0;
-    const int fire_interval_ = 120; // slower rate to match SFX length
+    const WeaponInfo *def_;         // Registry row (lives for the whole run)
+    bitmap image_{nullptr};         // Idle sprite
+    bitmap fire_image_{nullptr};    // Fire-frame sprite (falls back to idle)
+    bitmap shown_image_{nullptr};   // Sprite picked by the last update
+    bitmap bullet_img_{nullptr};    // Bullet sprite
+    std::vector<Bullet> bullets_;   // Bullets fired by this weapon
+    uint32_t next_slot_ = 0;        // emit_bullet search start
+    std::vector<RayHit> hits_;      // Hitscan scratch, reused every shot
+    std::vector<TargetQuery> seek_; // Homing scratch: one query per live bullet
+    std::vector<int> targets_;      // and the enemy it steers for
+    WeaponFx fx_;                   // Sparks, shells, muzzle flash
+
+    int fire_cooldown_ = 0;     // Frames until the next shot
+    int fire_frame_timer_ = 0;  // Frames left on the fire sprite
+    bool is_recoiling_ = false; // Recoil kick in progress
+    int recoil_timer_ = 0;      // Frames left on the kick
+    int spin_ = 0;              // Barrel spin, 0..spin_up
+    bool voice_on_ = false;     // Looped fire sound playing
+
+    void fire(GameWorld &world, const InputState &in, double angle_rad);
+    void fire_ray(GameWorld &world, double x, double y, double angle_rad, int damage);
+    void steer_homing(GameWorld &world);
+    void update_projectiles(GameWorld &world);
+    void set_voice(GameWorld &world, bool on);
 };
-
-// Gatling (high ROF, spread). While equipped: slow move, dash disabled.
-// (Gatling and Kelber removed)
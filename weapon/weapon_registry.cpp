@@ -0,0 +1,199 @@
+// Weapon registry: weapons.def parser and lookup table
+#include "weapon_registry.hpp"
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    struct Registry
+    {
+        std::vector<WeaponInfo> table; // Indexed by id; unused ids keep type None
+        std::vector<WeaponType> order; // Ids in file order
+        std::string error;
+    };
+
+    bool fail(Registry &reg, int line, const std::string &msg)
+    {
+        reg.error = std::string(kWeaponDefsPath) + ":" + std::to_string(line) + ": " + msg;
+        reg.table.clear();
+        reg.order.clear();
+        return false;
+    }
+
+    // Apply one "key values..." line to `w`; false on an unknown key or bad value
+    bool parse_key(WeaponInfo &w, const std::string &key, std::istringstream &in)
+    {
+        auto flag = [&](bool &out) { int v = 0; in >> v; out = v != 0; };
+        if (key == "image") in >> w.image_key >> w.image_path;
+        else if (key == "fire_image") in >> w.fire_image_key >> w.fire_image_path;
+        else if (key == "bullet") in >> w.bullet_key >> w.bullet_path;
+        else if (key == "sound") in >> w.sound_key >> w.sound_path >> w.volume;
+        else if (key == "spin_sound") in >> w.spin_sound_key >> w.spin_sound_path >> w.spin_volume;
+        else if (key == "loop_sound") in >> w.loop_sound_key >> w.loop_sound_path >> w.loop_volume;
+        else if (key == "price") in >> w.price;
+        else if (key == "starter") flag(w.starter);
+        else if (key == "trigger")
+        {
+            std::string mode;
+            in >> mode;
+            if (mode != "semi" && mode != "auto") return false;
+            w.full_auto = mode == "auto";
+        }
+        else if (key == "wait_recoil") flag(w.wait_recoil);
+        else if (key == "spin_up") in >> w.spin_up;
+        else if (key == "fire_interval") in >> w.fire_interval;
+        else if (key == "damage") in >> w.damage;
+        else if (key == "bullet_speed") in >> w.bullet_speed;
+        else if (key == "pellets")
+        {
+            w.pellet_count = 0;
+            double deg;
+            while (in >> deg)
+            {
+                if (w.pellet_count == kMaxPellets) return false;
+                w.pellets[w.pellet_count++] = deg;
+            }
+            return w.pellet_count > 0;
+        }
+        else if (key == "spread") in >> w.spread_deg;
+        else if (key == "piercing") flag(w.piercing);
+        else if (key == "pierce_limit") in >> w.pierce_limit;
+        else if (key == "pierce_falloff") in >> w.pierce_falloff;
+        else if (key == "hitscan") in >> w.hitscan;
+        else if (key == "beam_time") in >> w.beam_time;
+        else if (key == "homing")
+        {
+            in >> w.homing_turn_deg >> w.homing_radius >> w.homing_cone_deg;
+            return !in.fail() && w.homing_turn_deg > 0 && w.homing_radius > 0 && w.homing_cone_deg > 0;
+        }
+        else if (key == "recoil") in >> w.recoil_duration >> w.recoil_strength;
+        else if (key == "muzzle_time") in >> w.muzzle_time;
+        else if (key == "fire_frame_time") in >> w.fire_frame_time;
+        else if (key == "grip") in >> w.grip_x >> w.grip_y;
+        else if (key == "draw_offset") in >> w.draw_x >> w.draw_y;
+        else if (key == "muzzle_offsets")
+        {
+            for (int i = 0; i < 4; ++i) in >> w.muzzle_dx[i] >> w.muzzle_dy[i];
+        }
+        else if (key == "shell_follows_aim") flag(w.shell_follows_aim);
+        else if (key == "sparks")
+        {
+            SparkStyle &s = w.sparks;
+            in >> s.count >> s.count_rand >> s.spread_deg >> s.speed >> s.speed_rand >> s.length >> s.length_rand;
+        }
+        else if (key == "spark_color") in >> w.sparks.r >> w.sparks.g >> w.sparks.g_rand >> w.sparks.b;
+        else if (key == "move_speed") in >> w.move_speed;
+        else if (key == "no_dash") flag(w.no_dash);
+        else return false;
+        return !in.fail();
+    }
+
+    bool load(Registry &reg, const char *path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+            return fail(reg, 0, "cannot open");
+
+        WeaponInfo cur;
+        bool in_block = false;
+        std::string raw;
+        for (int line = 1; std::getline(file, raw); ++line)
+        {
+            std::istringstream in(raw.substr(0, raw.find('#')));
+            std::string key;
+            if (!(in >> key))
+                continue;
+
+            if (key == "weapon")
+            {
+                int id = -1;
+                std::string name;
+                if (in_block || !(in >> id >> name) || id < 0 || id >= kMaxWeaponTypes)
+                    return fail(reg, line, "expected 'weapon <id 0-63> <name>' outside a block");
+                if (id < (int)reg.table.size() && reg.table[id].type != WeaponType::None)
+                    return fail(reg, line, "duplicate weapon id " + std::to_string(id));
+                cur = WeaponInfo();
+                cur.type = (WeaponType)id;
+                cur.name = name;
+                in_block = true;
+            }
+            else if (key == "end")
+            {
+                if (!in_block)
+                    return fail(reg, line, "'end' without 'weapon'");
+                if (cur.image_key.empty() || cur.bullet_key.empty() || cur.fire_interval < 1 || cur.recoil_duration < 1)
+                    return fail(reg, line, cur.name + " needs image, bullet and positive fire_interval/recoil");
+                int id = (int)cur.type;
+                if ((int)reg.table.size() <= id)
+                    reg.table.resize(id + 1);
+                reg.table[id] = cur;
+                reg.order.push_back(cur.type);
+                in_block = false;
+            }
+            else if (!in_block || !parse_key(cur, key, in))
+            {
+                return fail(reg, line, "bad line '" + key + "'");
+            }
+        }
+        if (in_block)
+            return fail(reg, 0, "missing 'end'");
+        if (reg.order.empty())
+            return fail(reg, 0, "no weapons defined");
+        return true;
+    }
+
+    // Parsed on first use (thread-safe), never reloaded
+    Registry &registry()
+    {
+        static Registry reg = [] {
+            Registry r;
+            load(r, kWeaponDefsPath);
+            return r;
+        }();
+        return reg;
+    }
+}
+
+const WeaponInfo &weapon_info(WeaponType type)
+{
+    return registry().table[(int)type];
+}
+
+bool is_weapon_type(int id)
+{
+    const Registry &reg = registry();
+    return id >= 0 && id < (int)reg.table.size() && reg.table[id].type != WeaponType::None;
+}
+
+const std::vector<WeaponType> &weapon_types()
+{
+    return registry().order;
+}
+
+const std::string &weapon_defs_error()
+{
+    return registry().error;
+}
+
+std::unique_ptr<WeaponBase> create_weapon(WeaponType type)
+{
+    if (!is_weapon_type((int)type))
+        return nullptr;
+    return std::make_unique<Firearm>(weapon_info(type));
+}
+
+void load_weapon_images()
+{
+    bitmap muzzle = load_bitmap("muzzle_flash", "../image/weapon/muzzle_flash.png");
+    bitmap shell = load_bitmap("shell_img", "../image/weapon/shell.png");
+    for (auto &info : registry().table)
+    {
+        if (info.type == WeaponType::None || info.icon)
+            continue;
+        info.icon = load_bitmap(info.image_key, info.image_path);
+        info.fire_image = info.fire_image_key.empty() ? info.icon : load_bitmap(info.fire_image_key, info.fire_image_path);
+        info.bullet_image = load_bitmap(info.bullet_key, info.bullet_path);
+        info.muzzle_image = muzzle;
+        info.shell_image = shell;
+    }
+}
@@ -0,0 +1,106 @@
+// Weapon registry: stable type ids, per-type definitions and the one factory.
+// Definitions are read once from weapon/weapons.def into a compact table;
+// every weapon is a Firearm driven by its row. Saves, snapshots and the shop
+// identify weapons only through the ids.
+#pragma once
+#include "weapon_base.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+const char *const kWeaponDefsPath = "weapon/weapons.def";
+const int kMaxPellets = 16;
+const int kMaxWeaponTypes = 64;
+
+// Hit spark look: counts, spread and sizes are base + rand() % extra
+struct SparkStyle
+{
+    int count = 5, count_rand = 4;
+    int spread_deg = 30; // Scatter either side of the reversed bullet heading
+    int speed = 5, speed_rand = 6;
+    int length = 8, length_rand = 12;
+    int r = 255, g = 220, g_rand = 35, b = 50;
+};
+
+// One weapon definition (see weapons.def for the meaning of each key)
+struct WeaponInfo
+{
+    WeaponType type = WeaponType::None;
+    std::string name;                            // Display name in the shop
+    std::string image_key, image_path;           // Weapon sprite and shop icon
+    std::string fire_image_key, fire_image_path; // Optional fire-frame sprite
+    std::string bullet_key, bullet_path;         // Bullet sprite
+    std::string sound_key, sound_path;           // Per-shot sound (optional)
+    double volume = 1.0;
+    std::string spin_sound_key, spin_sound_path; // Played as the barrels start
+    double spin_volume = 1.0;
+    std::string loop_sound_key, loop_sound_path; // Looped while firing (optional)
+    double loop_volume = 1.0;
+
+    int price = 0;        // Shop price
+    bool starter = false; // Unlocked at the start of a run
+
+    bool full_auto = false;   // Fire while held (else on click)
+    bool wait_recoil = false; // No shot until the recoil recovered
+    int spin_up = 0;          // Frames of held trigger before the first shot
+    int fire_interval = 20;   // Frames between shots
+    int damage = 0;           // Damage per bullet
+    double bullet_speed = 0;  // Pixels per frame
+    bool piercing = false;
+    int pierce_limit = 0;        // Enemies a piercing shot may hit (0 = no cap)
+    double pierce_falloff = 1.0; // Damage kept after each enemy pierced
+    double pellets[kMaxPellets] = {0}; // Angle offsets (degrees), one bullet each
+    int pellet_count = 1;
+    double spread_deg = 0;             // Random extra angle per bullet, +-degrees
+    int hitscan = 0;                   // Enemies one ray may hit (0: fires projectiles)
+    int beam_time = 8;                 // Frames the hitscan beam stays visible
+    double homing_turn_deg = 0;        // Max turn per frame toward a target (0: flies straight)
+    double homing_radius = 0;          // How far from a bullet a target may be
+    double homing_cone_deg = 180;      // Targets within this angle of the heading
+
+    int recoil_duration = 20;     // Frames
+    double recoil_strength = 8.0; // Pixels
+    int muzzle_time = 4;          // Muzzle flash frames
+    int fire_frame_time = 0;      // Fire sprite frames
+    double grip_x = 0, grip_y = 0;          // Muzzle/shell origin from the player
+    double draw_x = 0, draw_y = 32;         // Sprite origin from the player
+    double muzzle_dx[4] = {0}, muzzle_dy[4] = {0}; // Flash offset per facing/aim case
+    bool shell_follows_aim = false;
+    SparkStyle sparks;
+
+    double move_speed = 2.0; // Player walk speed while held
+    bool no_dash = false;    // Dash disabled while held
+
+    // Loaded sprites, nullptr until load_weapon_images (weapons only copy the
+    // handles, so they can be created on the simulation thread)
+    bitmap icon = nullptr;         // Weapon sprite, also the shop icon
+    bitmap fire_image = nullptr;   // Fire-frame sprite (the icon when there is none)
+    bitmap bullet_image = nullptr;
+    bitmap muzzle_image = nullptr; // Muzzle flash and ejected shell, shared by every weapon
+    bitmap shell_image = nullptr;
+};
+
+// Definition of a registered type (check with is_weapon_type first)
+const WeaponInfo &weapon_info(WeaponType type);
+
+// True for ids that name a registered weapon (e.g. values read from a save)
+bool is_weapon_type(int id);
+
+// Registered ids in definition-file order
+const std::vector<WeaponType> &weapon_types();
+
+// Empty when weapons.def loaded fine, else what went wrong
+const std::string &weapon_defs_error();
+
+// New weapon of the given type, or nullptr for None/unknown ids
+std::unique_ptr<WeaponBase> create_weapon(WeaponType type);
+
+// Load every weapon's sprites once and cache the handles in the registry
+// (window thread, before any weapon's load_assets)
+void load_weapon_images();
+
+// Type of the weapon in a slot, None when empty
+inline WeaponType weapon_type_of(const WeaponBase *w)
+{
+    return w ? w->type_id() : WeaponType::None;
+}